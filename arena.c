@@ -0,0 +1,217 @@
+#include "arena.h"
+
+/*a union of the types with the strictest alignment the tables use*/
+typedef union{
+	long l;
+	double d;
+	void *p;
+} max_align;
+
+/*round a size up to a multiple of the strictest alignment*/
+#define ALIGN_SIZE(size) \
+	(((size) + sizeof(max_align) - 1) / sizeof(max_align) * sizeof(max_align))
+/*the size of a block header, rounded so the data after it is aligned*/
+#define BLOCK_HEADER_SIZE ALIGN_SIZE(sizeof(arena_block))
+/*a pointer to the first byte of data in a block*/
+#define BLOCK_DATA(block) ((char*)(block) + BLOCK_HEADER_SIZE)
+
+/* new_block  : allocate a new empty block
+ * parameters : size - the number of bytes the block can hold
+ * return     : a pointer to the new block or NULL if allocation failed*/
+static arena_block *new_block(const size_t size) {
+	arena_block *block;
+
+	if ((block = malloc(BLOCK_HEADER_SIZE + size))) {
+		block->next = NULL;
+		block->size = size;
+		block->used = 0;
+	}
+
+	return block;
+}
+
+/* arena_init : allocate an arena and its first block
+ * parameters : block_size - the size of the blocks the arena allocates
+ * return     : if succesfuly allocated then return a pointer to the arena
+ * 				else return NULL*/
+arena *arena_init(const size_t block_size) {
+	arena *arena_p;
+
+	if ((arena_p = malloc(sizeof(arena)))) {
+		arena_p->block_size = ALIGN_SIZE(block_size);
+		arena_p->reserved = BLOCK_HEADER_SIZE + arena_p->block_size;
+		arena_p->used = 0;
+		memset(arena_p->counts, 0, sizeof(arena_p->counts));
+
+		/*if the first block couldnt be allocated free the arena*/
+		if (!(arena_p->first = arena_p->current = new_block(arena_p->block_size))) {
+			free(arena_p);
+			arena_p = NULL;
+		}
+	}
+
+	return arena_p;
+}
+
+/* arena_free : free an arena and all of its blocks
+ * parameters : arena_p - a pointer to an arena
+ * return     :*/
+void arena_free(arena *arena_p) {
+	arena_block *block,
+				*next;
+
+	if (arena_p) {
+		for (block = arena_p->first; block; block = next) {
+			next = block->next;
+			free(block);
+		}
+		free(arena_p);
+	}
+}
+
+/* arena_reset : release everything allocated from the arena at once and clear its
+ * 				 counts, the blocks are kept and reused by the next allocations, a
+ * 				 block is only emptied when the allocations reach it again
+ * parameters  : arena_p - a pointer to an arena
+ * return      :*/
+void arena_reset(arena *arena_p) {
+	arena_p->current = arena_p->first;
+	arena_p->first->used = 0;
+	arena_p->used = 0;
+	memset(arena_p->counts, 0, sizeof(arena_p->counts));
+}
+
+/* count_live : change the bytes a part of the assembler holds and keep the most
+ * 				it held
+ * parameters : counts - a pointer to the counts of the part
+ * 				change - the number of bytes added, negative if the part shrank
+ * return     :*/
+static void count_live(arena_counts *counts, const long change) {
+	counts->live += change;
+	if (counts->live > counts->peak)
+		counts->peak = counts->live;
+}
+
+/* take_bytes : take memory from the blocks of the arena without counting it for
+ * 				a part of the assembler
+ * parameters : arena_p - a pointer to an arena
+ * 				size    - the number of bytes to take
+ * return     : a pointer to the memory or NULL if allocation failed*/
+static void *take_bytes(arena *arena_p, const size_t size) {
+	arena_block *block = arena_p->current,
+				*next;
+	size_t 		aligned = ALIGN_SIZE(size);
+
+	/*if the current block is full move to the next kept block if it fits
+	 * else replace the kept block with a new block that does*/
+	if (block->used + aligned > block->size) {
+		if ((next = block->next) && aligned <= next->size)
+			next->used = 0;
+		else {
+			if (next) {
+				block->next = next->next;
+				arena_p->reserved -= BLOCK_HEADER_SIZE + next->size;
+				free(next);
+			}
+			if (!(next = new_block(aligned > arena_p->block_size ?
+									aligned : arena_p->block_size)))
+				return NULL;
+			arena_p->reserved += BLOCK_HEADER_SIZE + next->size;
+			next->next = block->next;
+			block->next = next;
+		}
+
+		arena_p->current = block = next;
+	}
+
+	block->used += aligned;
+	arena_p->used += aligned;
+
+	return BLOCK_DATA(block) + block->used - aligned;
+}
+
+/* arena_alloc : allocate memory from the arena for a part of the assembler
+ * parameters  : arena_p - a pointer to an arena
+ * 				 tag     - the part the memory is counted for
+ * 				 size    - the number of bytes to allocate
+ * return      : a pointer to the allocated memory or NULL if allocation failed*/
+void *arena_alloc(arena *arena_p, const arena_tag tag, const size_t size) {
+	void *ptr;
+
+	if ((ptr = take_bytes(arena_p, size))) {
+		arena_p->counts[tag].allocs++;
+		arena_p->counts[tag].requested += size;
+		count_live(&arena_p->counts[tag], size);
+	}
+
+	return ptr;
+}
+
+/* arena_realloc : grow a previous allocation from the arena
+ * 				   if it is the last allocation and there is room it grows in place
+ * 				   else the contents are copied to a new allocation
+ * parameters    : arena_p  - a pointer to an arena
+ * 				   tag      - the part the memory is counted for
+ * 				   ptr      - the previous allocation or NULL
+ * 				   old_size - the size of the previous allocation
+ * 				   new_size - the size to grow to
+ * return        : a pointer to the grown memory or NULL if allocation failed*/
+void *arena_realloc(arena *arena_p, const arena_tag tag, void *ptr,
+					const size_t old_size, const size_t new_size) {
+	arena_block *block = arena_p->current;
+	size_t 		old_aligned = ALIGN_SIZE(old_size),
+				new_aligned = ALIGN_SIZE(new_size);
+	void 		*new_ptr;
+
+	/*check if the allocation is the last one in the current block and can grow*/
+	if (ptr && (char*)ptr + old_aligned == BLOCK_DATA(block) + block->used &&
+		block->used - old_aligned + new_aligned <= block->size) {
+		block->used = block->used - old_aligned + new_aligned;
+		arena_p->used = arena_p->used - old_aligned + new_aligned;
+		new_ptr = ptr;
+	} else if ((new_ptr = take_bytes(arena_p, new_size)) && ptr)
+		memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+
+	if (new_ptr) {
+		if (ptr)
+			arena_p->counts[tag].reallocs++;
+		else
+			arena_p->counts[tag].allocs++;
+		arena_p->counts[tag].requested += new_size;
+		count_live(&arena_p->counts[tag], (long)new_size - (long)(ptr ? old_size : 0));
+	}
+
+	return new_ptr;
+}
+
+/* arena_strdup : copy a string to memory allocated from the arena
+ * parameters   : arena_p - a pointer to an arena
+ * 				  tag     - the part the memory is counted for
+ * 				  str     - the string to copy
+ * return       : a pointer to the copy or NULL if allocation failed*/
+char *arena_strdup(arena *arena_p, const arena_tag tag, const char *str) {
+	char *copy;
+
+	if ((copy = arena_alloc(arena_p, tag, strlen(str) + 1)))
+		strcpy(copy, str);
+
+	return copy;
+}
+
+/* arena_strndup : copy a part of a string to memory allocated from the arena
+ * parameters    : arena_p - a pointer to an arena
+ * 				   tag     - the part the memory is counted for
+ * 				   str     - the start of the part to copy
+ * 				   len     - the number of characters to copy
+ * return        : a pointer to the terminated copy or NULL if allocation failed*/
+char *arena_strndup(arena *arena_p, const arena_tag tag, const char *str,
+					const size_t len) {
+	char *copy;
+
+	if ((copy = arena_alloc(arena_p, tag, len + 1))) {
+		memcpy(copy, str, len);
+		copy[len] = '\0';
+	}
+
+	return copy;
+}
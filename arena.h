@@ -0,0 +1,60 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "defs.h"
+
+/* a block of memory owned by an arena, the allocations are taken from the bytes
+ * that follow the header of the block*/
+typedef struct arena_block {
+	struct arena_block *next;
+	size_t size;
+	size_t used;
+} arena_block;
+
+/*the parts of the assembler that allocate from an arena, they are counted apart*/
+typedef enum{
+	ARENA_SYMTABLE,
+	ARENA_CODE,
+	ARENA_DATA,
+	ARENA_IR,
+	ARENA_PARSER,
+	ARENA_OTHER,
+	NUM_OF_ARENA_TAGS
+} arena_tag;
+
+/* a struct representing what a part of the assembler allocated from an arena since
+ * it was reset, requested is the sum of the sizes asked for (a reallocation asks
+ * for its new size), live is what the part holds now and peak is the most it held
+ * memory a part grew out of is only reused after the reset so it isnt live*/
+typedef struct{
+	long allocs;
+	long reallocs;
+	long requested;
+	long live;
+	long peak;
+} arena_counts;
+
+/* a struct representing an arena, a list of blocks that allocations are taken from
+ * in order and are all released at once when the arena is reset
+ * the blocks are kept after a reset so they can be reused
+ * used is the number of bytes taken from the blocks since the reset, the most the
+ * arena needed since nothing is released before it, and reserved is the number of
+ * bytes of the blocks the arena holds*/
+typedef struct{
+	arena_block *first;
+	arena_block *current;
+	size_t block_size;
+	size_t used;
+	size_t reserved;
+	arena_counts counts[NUM_OF_ARENA_TAGS];
+} arena;
+
+arena *arena_init(const size_t);
+void arena_free(arena*);
+void arena_reset(arena*);
+void *arena_alloc(arena*, const arena_tag, const size_t);
+void *arena_realloc(arena*, const arena_tag, void*, const size_t, const size_t);
+char *arena_strdup(arena*, const arena_tag, const char*);
+char *arena_strndup(arena*, const arena_tag, const char*, const size_t);
+
+#endif
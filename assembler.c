@@ -1,77 +1,210 @@
+#include <limits.h>
 #include "defs.h"
-#include "file_handler.h"
 #include "error.h"
-#include "symtable.h"
-#include "memory_image.h"
-#include "pass1.h"
-#include "pass2.h"
+#include "context.h"
+#include "job.h"
+#include "pool.h"
+#include "stats.h"
+#include "trace.h"
+#include "cache.h"
+#include "scan.h"
+
+/*the option for the number of files to assemble in parallel*/
+#define JOBS_OPTION "-j"
+/*the options for the statistics of every file as text and as JSON*/
+#define STATS_OPTION "--stats"
+#define STATS_JSON_OPTION "--stats=json"
+/*the option for the file to write a trace of the assembly to*/
+#define TRACE_OPTION "--trace="
+/*the options for the directory of the build cache and its size in megabytes*/
+#define CACHE_OPTION "--cache="
+#define CACHE_SIZE_OPTION "--cache-size="
+/*the option to leave the output files that are the same as before untouched*/
+#define KEEP_UNCHANGED_OPTION "--keep-unchanged"
+
+/* a struct representing the options given to the assembler
+ * trace_file is NULL if no trace is written and the directory of the cache is NULL
+ * if there is no cache*/
+typedef struct{
+	int num_of_workers;
+	stats_format stats;
+	const char *trace_file;
+	build_cache cache;
+	int keep_unchanged;
+} assembler_options;
+
+/* parse_jobs_option : parse the option for the number of files to assemble in
+ * 					   parallel, given as "-j N" or "-jN"
+ * parameters        : argc           - the number of arguments
+ * 					   argv           - the arguments
+ * 					   index          - a pointer to the index of the option, it is
+ * 										moved past the number
+ * 					   num_of_workers - the output for the number of workers
+ * return            : NO_ERROR            - if the number is valid
+ * 					   INVALID_NUM_OF_JOBS - if the number of jobs is invalid*/
+static error_value parse_jobs_option(int argc, char **argv, int *index,
+									 int *num_of_workers) {
+	const char *num;
+	int 	   i;
+
+	/*the number can be in the same argument or in the next one*/
+	if (argv[*index][strlen(JOBS_OPTION)])
+		num = argv[(*index)++] + strlen(JOBS_OPTION);
+	else {
+		num = *index + 1 < argc ? argv[*index + 1] : "";
+		*index += 2;
+	}
+
+	/*the number must be a positive decimal number*/
+	for (i = 0; char_is(num[i], CHAR_DIGIT); i++);
+	if (!i || num[i] || (*num_of_workers = atoi(num)) <= 0)
+		return INVALID_NUM_OF_JOBS;
+
+	return NO_ERROR;
+}
+
+/* parse_cache_size : parse the size of the build cache in megabytes
+ * parameters       : num   - the size as it was given
+ * 					  cache - a pointer to the cache to set the size of
+ * return           : NO_ERROR       - if the size is valid
+ * 					  INVALID_OPTION - if the size isnt a positive decimal number*/
+static error_value parse_cache_size(const char *num, build_cache *cache) {
+	int i;
+
+	for (i = 0; char_is(num[i], CHAR_DIGIT); i++);
+	if (!i || num[i] || atol(num) <= 0 || atol(num) > LONG_MAX / (1024 * 1024))
+		return INVALID_OPTION;
+	cache->max_size = atol(num) * 1024 * 1024;
+
+	return NO_ERROR;
+}
+
+/* parse_options : parse the options given before the files
+ * parameters    : argc       - the number of arguments
+ * 				   argv       - the arguments
+ * 				   options    - the output for the options
+ * 				   first_file - the output for the index of the first file
+ * return        : NO_ERROR            - if the options are valid
+ * 				   INVALID_NUM_OF_JOBS - if the number of jobs is invalid
+ * 				   INVALID_OPTION      - if an option is unknown*/
+static error_value parse_options(int argc, char **argv, assembler_options *options,
+								 int *first_file) {
+	error_value err_val = NO_ERROR;
+	int 		i = 1;
+
+	options->num_of_workers = 1;
+	options->stats = STATS_OFF;
+	options->trace_file = NULL;
+	options->cache.dir = NULL;
+	options->cache.max_size = DEFAULT_CACHE_SIZE_MB * 1024L * 1024L;
+	options->keep_unchanged = FALSE;
+
+	while (!err_val && i < argc && argv[i][0] == '-') {
+		if (!strcmp(argv[i], STATS_OPTION))
+			options->stats = STATS_TEXT;
+		else if (!strcmp(argv[i], STATS_JSON_OPTION))
+			options->stats = STATS_JSON;
+		else if (!strcmp(argv[i], KEEP_UNCHANGED_OPTION))
+			options->keep_unchanged = TRUE;
+		else if (!strncmp(argv[i], TRACE_OPTION, strlen(TRACE_OPTION)) &&
+				 argv[i][strlen(TRACE_OPTION)])
+			options->trace_file = argv[i] + strlen(TRACE_OPTION);
+		else if (!strncmp(argv[i], CACHE_OPTION, strlen(CACHE_OPTION)) &&
+				 argv[i][strlen(CACHE_OPTION)])
+			options->cache.dir = argv[i] + strlen(CACHE_OPTION);
+		else if (!strncmp(argv[i], CACHE_SIZE_OPTION, strlen(CACHE_SIZE_OPTION)))
+			err_val = parse_cache_size(argv[i] + strlen(CACHE_SIZE_OPTION),
+									   &options->cache);
+		else if (!strncmp(argv[i], JOBS_OPTION, strlen(JOBS_OPTION))) {
+			err_val = parse_jobs_option(argc, argv, &i, &options->num_of_workers);
+			continue;
+		} else
+			err_val = INVALID_OPTION;
+		if (!err_val)
+			i++;
+	}
+	*first_file = i;
+
+	return err_val;
+}
 
 /* entry point */
 int main(int argc, char **argv) {
-	int 		 i;
-	FILE 		 *fp;
-	error_value  err_val = NO_ERROR;
-	memory_image *memory_image_p;
-	symtable     *symtable_p;
-	char 	     file_name[MAX_FILE_NAME_LEN];
+	error_value		  err_val;
+	int 		 	  i,
+					  first_file,
+					  num_of_files;
+	double 			  begin = stats_clock();
+	assembler_options options;
+	file_job	 	  *jobs;
+	assembly_stats	  *stats = NULL;
+	assembly_context  *context;
+
+	/* check how many files to assemble in parallel, if statistics are asked for,
+	 * if a trace is written and if there is a build cache*/
+	if ((err_val = parse_options(argc, argv, &options, &first_file))) {
+		print_error(err_val, argv[first_file], 0);
+		return EXIT_FAILURE;
+	}
 
 	/*check if files were provided to procces*/
-	if (argc <= 1) {
+	if (argc <= first_file) {
 		print_error(NO_PARAMETERS, 0, 0);
 		return EXIT_FAILURE;
 	}
 
-	/*itterate over the provided files and procces them*/
-	for (i = 1; i < argc; i++) {
-		/*create a full file name with .as extention from provided base name*/
-		make_file_name(argv[i], CODE_FILE_EXT, file_name);
-
-		/*check if the file exists*/
-		if (!(err_val = file_exists(file_name))) {
-
-			/*if the file exists try to open it to read*/
-			if ((fp = fopen(file_name, READ))) {
-
-				/*if file was successfully opened try to initialize the memory image
-				 * and the symtable*/
-				if ((memory_image_p = memory_image_init()) &&
-						(symtable_p = symtable_init())) {
-
-					/*if successfully initialized then execute first pass on the given file*/
-					if (!(err_val = pass1_execute(fp, memory_image_p,
-							symtable_p, file_name))) {
-
-						/*if no errors occured during the first pass then prepare for
-						 * the second pass and execute it on the given file*/
-						pass2_prep(fp, memory_image_p, symtable_p);
-						if (!(err_val = pass2_execute(fp, memory_image_p,
-								symtable_p, file_name)))
-
-							/*if no error occured during the second pass the create
-							 * the object file and if needed then the externals and
-							 * entries files*/
-							err_val = create_files(argv[i], memory_image_p,
-									symtable_p);
-					}
-					/*free the initialized memory_image and symtable*/
-					memory_image_free(memory_image_p);
-					symtable_free(symtable_p);
-					fclose(fp);
-				} else {
-
-					/*if couldnt initialize the memory image of the symtable
-					 * close the file and throw an error*/
-					fclose(fp);
-					err_val = ERROR_MEMORY_ALLOC;
-				}
-			} else
-				/*if couldn open the file throw an error*/
-				err_val = ERROR_OPEN_FILE;
+	/*prepare a job for every provided file*/
+	num_of_files = argc - first_file;
+	if (!(jobs = malloc(num_of_files * sizeof(file_job))) ||
+		((options.stats != STATS_OFF || options.trace_file) &&
+		 !(stats = malloc(num_of_files * sizeof(assembly_stats))))) {
+		print_error(ERROR_MEMORY_ALLOC, argv[0], 0);
+		return EXIT_FAILURE;
+	}
+	for (i = 0; i < num_of_files; i++) {
+		if (file_job_init(&jobs[i], argv[first_file + i])) {
+			print_error(ERROR_MEMORY_ALLOC, argv[0], 0);
+			return EXIT_FAILURE;
+		}
+		if (options.cache.dir)
+			jobs[i].cache = &options.cache;
+		jobs[i].keep_unchanged = options.keep_unchanged;
+		/*a file has statistics only if they or a trace were asked for*/
+		if (stats) {
+			stats_init(&stats[i], options.stats);
+			jobs[i].stats = &stats[i];
+		}
+	}
+
+	/*if the files cant be assembled in parallel itterate over them and procces
+	 * them one after another with one assembly context that is reused*/
+	if (options.num_of_workers == 1 ||
+		run_pool(jobs, num_of_files, options.num_of_workers)) {
+		if (!(context = context_init())) {
+			print_error(ERROR_MEMORY_ALLOC, argv[0], 0);
+			return EXIT_FAILURE;
+		}
+
+		for (i = 0; i < num_of_files; i++) {
+			assemble_file(context, &jobs[i]);
+			file_job_report(&jobs[i]);
 		}
 
-		print_error(err_val, file_name, 0);
-		printf("\n");
+		context_free(context);
 	}
 
+	/*the cache is kept to its size once all the files were assembled*/
+	if (options.cache.dir)
+		cache_evict(&options.cache);
+
+	/*the trace is made from the statistics of the files*/
+	if (options.trace_file &&
+		(err_val = write_trace(options.trace_file, jobs, num_of_files, begin,
+							   stats_clock())))
+		print_error(err_val, options.trace_file, 0);
+
+	free(stats);
+	free(jobs);
+
 	return EXIT_SUCCESS;
 }
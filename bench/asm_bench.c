@@ -0,0 +1,553 @@
+#define _GNU_SOURCE
+
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "../context.h"
+#include "../source.h"
+#include "../pass1.h"
+#include "../pass2.h"
+#include "../file_handler.h"
+
+/*the number of times every file is assembled, the fastest time is reported*/
+#define DEFAULT_REPEATS 3
+/*the longest line of a results file*/
+#define MAX_RESULT_LINE_LEN 4096
+/*the longest name of a case*/
+#define MAX_CASE_NAME_LEN 64
+
+/*the phases that are measured*/
+typedef enum{
+	PASS1_PHASE,
+	PASS2_PHASE,
+	CREATE_FILES_PHASE,
+	NUM_OF_PHASES
+} bench_phase;
+
+/*the names of the phases in the report and in the results*/
+static const char *phase_names[NUM_OF_PHASES] = {"pass1", "pass2", "create_files"};
+
+/*the hardware counters that are read around every phase*/
+typedef enum{
+	CYCLES_COUNTER,
+	INSTRUCTIONS_COUNTER,
+	CACHE_MISSES_COUNTER,
+	BRANCH_MISSES_COUNTER,
+	NUM_OF_COUNTERS
+} bench_counter;
+
+/*the names of the counters in the results*/
+static const char *counter_names[NUM_OF_COUNTERS] = {
+	"cycles", "instructions", "cache_misses", "branch_misses"
+};
+
+/* a struct representing the hardware counters of the process, they are one group
+ * led by the cycles so they count the same instructions, a counter that couldnt
+ * be opened has no file descriptor (-1)*/
+typedef struct{
+	int fds[NUM_OF_COUNTERS];
+} perf_counters;
+
+/* a struct representing the measures of a file
+ * the peak rss of a phase is the most memory the process held by its end
+ * a count of a counter that isnt available is negative*/
+typedef struct{
+	char name[MAX_CASE_NAME_LEN];
+	long lines;
+	long bytes;
+	error_value err_val;
+	double seconds[NUM_OF_PHASES];
+	long peak_rss_kb[NUM_OF_PHASES];
+	double counts[NUM_OF_PHASES][NUM_OF_COUNTERS];
+} bench_result;
+
+#ifdef __linux__
+
+/*the hardware events of the counters*/
+static const unsigned long counter_events[NUM_OF_COUNTERS] = {
+	PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+	PERF_COUNT_HW_BRANCH_MISSES
+};
+
+/* counters_open : open the hardware counters of the process, only what runs in
+ * 				   user space is counted so it works without privileges
+ * parameters    : counters - the output for the counters
+ * return        : TRUE if at least the cycles can be counted else FALSE*/
+static int counters_open(perf_counters *counters) {
+	struct perf_event_attr attr;
+	int 				   i;
+
+	for (i = 0; i < NUM_OF_COUNTERS; i++) {
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = counter_events[i];
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		/*the group starts and stops with its leader*/
+		attr.disabled = !i;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		counters->fds[i] = counters->fds[CYCLES_COUNTER] < 0 && i ? -1 :
+						   (int)syscall(__NR_perf_event_open, &attr, 0, -1,
+										i ? counters->fds[CYCLES_COUNTER] : -1, 0);
+	}
+
+	return counters->fds[CYCLES_COUNTER] >= 0;
+}
+
+/* counters_start : start counting from 0
+ * parameters     : counters - a pointer to the counters
+ * return         :*/
+static void counters_start(const perf_counters *counters) {
+	if (counters->fds[CYCLES_COUNTER] >= 0) {
+		ioctl(counters->fds[CYCLES_COUNTER], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(counters->fds[CYCLES_COUNTER], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	}
+}
+
+/* counters_stop : stop counting and read the counts, a count of a counter that
+ * 				   shared the hardware with others is scaled to the whole time
+ * parameters    : counters - a pointer to the counters
+ * 				   counts   - the output for the counts, negative if not available
+ * return        :*/
+static void counters_stop(const perf_counters *counters, double counts[NUM_OF_COUNTERS]) {
+	__u64 			   values[3];
+	int 			   i;
+
+	if (counters->fds[CYCLES_COUNTER] >= 0)
+		ioctl(counters->fds[CYCLES_COUNTER], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+	/*a value is followed by the time it was enabled and the time it counted*/
+	for (i = 0; i < NUM_OF_COUNTERS; i++)
+		counts[i] = counters->fds[i] >= 0 &&
+					read(counters->fds[i], values, sizeof(values)) == sizeof(values) &&
+					values[2] ? (double)values[0] * values[1] / values[2] : -1;
+}
+
+/* counters_close : close the hardware counters
+ * parameters     : counters - a pointer to the counters
+ * return         :*/
+static void counters_close(perf_counters *counters) {
+	int i;
+
+	for (i = 0; i < NUM_OF_COUNTERS; i++)
+		if (counters->fds[i] >= 0)
+			close(counters->fds[i]);
+}
+
+#else
+
+/* counters_open : the hardware counters are read only on linux
+ * parameters    : counters - the output for the counters
+ * return        : FALSE*/
+static int counters_open(perf_counters *counters) {
+	int i;
+
+	for (i = 0; i < NUM_OF_COUNTERS; i++)
+		counters->fds[i] = -1;
+
+	return FALSE;
+}
+
+/* counters_start : the hardware counters are read only on linux
+ * parameters     : counters - a pointer to the counters
+ * return         :*/
+static void counters_start(const perf_counters *counters) {
+}
+
+/* counters_stop : the hardware counters are read only on linux
+ * parameters    : counters - a pointer to the counters
+ * 				   counts   - the output for the counts, all not available
+ * return        :*/
+static void counters_stop(const perf_counters *counters, double counts[NUM_OF_COUNTERS]) {
+	int i;
+
+	for (i = 0; i < NUM_OF_COUNTERS; i++)
+		counts[i] = -1;
+}
+
+/* counters_close : the hardware counters are read only on linux
+ * parameters     : counters - a pointer to the counters
+ * return         :*/
+static void counters_close(perf_counters *counters) {
+}
+
+#endif
+
+/* now_seconds : get the time of a clock that only goes forward
+ * parameters  :
+ * return      : the time in seconds*/
+static double now_seconds() {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* peak_rss_kb : get the most memory the process held so far
+ * parameters  :
+ * return      : the peak resident set size in kilobytes*/
+static long peak_rss_kb() {
+	struct rusage usage;
+
+	getrusage(RUSAGE_SELF, &usage);
+
+	return usage.ru_maxrss;
+}
+
+/* count_lines : count the lines of a source file, a last line without a '\n'
+ * 				 counts as well
+ * parameters  : source - a pointer to the source file
+ * return      : the number of lines*/
+static long count_lines(const source_file *source) {
+	const char *pos = source->data,
+			   *end = source->data + source->size;
+	long 	   lines = 0;
+
+	while (pos < end && (pos = memchr(pos, '\n', end - pos))) {
+		lines++;
+		pos++;
+	}
+
+	return lines + (source->size && source->data[source->size - 1] != '\n');
+}
+
+/* start_phase : start measuring a phase
+ * parameters  : counters - a pointer to the hardware counters
+ * return      : the time the phase started*/
+static double start_phase(const perf_counters *counters) {
+	counters_start(counters);
+
+	return now_seconds();
+}
+
+/* end_phase  : keep the time, the counts and the memory of a phase of one run of a
+ * 				file, the least time and counts of all the runs are kept
+ * parameters : result   - a pointer to the measures of the file
+ * 				phase    - the phase that ended
+ * 				start    - the time the phase started
+ * 				counters - a pointer to the hardware counters
+ * return     :*/
+static void end_phase(bench_result *result, const bench_phase phase, double start,
+					  const perf_counters *counters) {
+	double end = now_seconds(),
+		   counts[NUM_OF_COUNTERS];
+	int    i;
+
+	counters_stop(counters, counts);
+	if (!result->seconds[phase] || end - start < result->seconds[phase])
+		result->seconds[phase] = end - start;
+	for (i = 0; i < NUM_OF_COUNTERS; i++)
+		if (result->counts[phase][i] <= 0 ||
+			(counts[i] >= 0 && counts[i] < result->counts[phase][i]))
+			result->counts[phase][i] = counts[i];
+	result->peak_rss_kb[phase] = peak_rss_kb();
+}
+
+/* bench_file : assemble a file a number of times phase by phase like
+ * 				assemble_file does and measure every phase
+ * parameters : context   - a pointer to the assembly context to use
+ * 				file_base - the base name of the file
+ * 				repeats   - the number of times to assemble it
+ * 				result    - the output for the measures
+ * return     : NO_ERROR - if the file was assembled every time
+ * 				else the error of the file*/
+static error_value bench_file(assembly_context *context, const char *file_base,
+							  const int repeats, bench_result *result) {
+	error_value   err_val = NO_ERROR;
+	diagnostics   diag;
+	source_file   source;
+	perf_counters counters;
+	char 		  *file_name;
+	double 		  start;
+	int 		  r;
+
+	if (!(file_name = new_file_name(file_base, CODE_FILE_EXT)))
+		return ERROR_MEMORY_ALLOC;
+	diagnostics_init(&diag);
+	context->diag = &diag;
+	/*without the counters only the time and the memory are measured*/
+	counters_open(&counters);
+
+	for (r = 0; !err_val && r < repeats; r++) {
+		if ((err_val = source_open(&source, file_name)))
+			break;
+		result->lines = count_lines(&source);
+		result->bytes = source.size;
+
+		/*the first pass includes preparing the context for the file*/
+		start = start_phase(&counters);
+		if (!(err_val = context_reset(context)) &&
+			!(err_val = memory_image_reserve(context->mem_img, source.size)))
+			err_val = pass1_execute(&source, context, file_name);
+		end_phase(result, PASS1_PHASE, start, &counters);
+
+		if (!err_val) {
+			start = start_phase(&counters);
+			pass2_prep(context);
+			err_val = pass2_execute(context, file_name);
+			end_phase(result, PASS2_PHASE, start, &counters);
+		}
+		if (!err_val) {
+			start = start_phase(&counters);
+			err_val = create_files(file_base, context->mem_img, context->symtable,
+								   NULL, FALSE, NULL);
+			end_phase(result, CREATE_FILES_PHASE, start, &counters);
+		}
+		source_close(&source);
+	}
+
+	counters_close(&counters);
+	context->diag = NULL;
+	diagnostics_flush(&diag);
+	free(file_name);
+
+	return err_val;
+}
+
+/* run_case   : measure a file in a process of its own so the peak memory of one
+ * 				file doesnt show in the next one
+ * parameters : file_base - the base name of the file
+ * 				repeats   - the number of times to assemble it
+ * 				result    - the output for the measures
+ * return     : NO_ERROR           - if the file was measured
+ * 				ERROR_MEMORY_ALLOC - if the process couldnt be made
+ * 				else the error of the file*/
+static error_value run_case(const char *file_base, const int repeats,
+							bench_result *result) {
+	assembly_context *context;
+	const char 		 *name;
+	char 			 *pos;
+	int 			 fds[2],
+					 status;
+	pid_t 			 pid;
+	ssize_t 		 len = 0;
+
+	memset(result, 0, sizeof(bench_result));
+	name = (name = strrchr(file_base, '/')) ? name + 1 : file_base;
+	strncpy(result->name, name, MAX_CASE_NAME_LEN - 1);
+
+	/*what is printed so far must not be printed again by the child*/
+	fflush(stdout);
+	if (pipe(fds))
+		return ERROR_MEMORY_ALLOC;
+	if ((pid = fork()) < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		return ERROR_MEMORY_ALLOC;
+	}
+
+	/*the child measures the file and sends the result back*/
+	if (!pid) {
+		close(fds[0]);
+		if (!(context = context_init()))
+			result->err_val = ERROR_MEMORY_ALLOC;
+		else {
+			result->err_val = bench_file(context, file_base, repeats, result);
+			context_free(context);
+		}
+		fflush(stdout);
+		_exit(write(fds[1], result, sizeof(bench_result)) ==
+			  (ssize_t)sizeof(bench_result) ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	close(fds[1]);
+	for (pos = (char *)result; pos < (char *)(result + 1) &&
+		 (len = read(fds[0], pos, (char *)(result + 1) - pos)) > 0; pos += len);
+	close(fds[0]);
+	waitpid(pid, &status, 0);
+
+	if (pos < (char *)(result + 1))
+		result->err_val = ERROR_MEMORY_ALLOC;
+
+	return result->err_val;
+}
+
+/* find_baseline : find the times and the instructions of a case in the results of
+ * 				   an earlier run
+ * parameters    : baseline     - the results file of the earlier run
+ * 				   name         - the name of the case
+ * 				   seconds      - the output for the time of every phase
+ * 				   instructions - the output for the instructions of every phase, 0
+ * 								  if they werent counted
+ * return        : TRUE if the case was found else FALSE*/
+static int find_baseline(FILE *baseline, const char *name, double seconds[NUM_OF_PHASES],
+						 double instructions[NUM_OF_PHASES]) {
+	char 	   line[MAX_RESULT_LINE_LEN],
+			   key[MAX_CASE_NAME_LEN + 32];
+	const char *pos;
+	int 	   phase;
+
+	/*every case is on a line of its own and its phases are in order*/
+	rewind(baseline);
+	sprintf(key, "{\"case\": \"%s\"", name);
+	while (fgets(line, sizeof(line), baseline)) {
+		if (strncmp(line, key, strlen(key)))
+			continue;
+		for (phase = 0; phase < NUM_OF_PHASES; phase++) {
+			sprintf(key, "\"%s\": {\"seconds\": ", phase_names[phase]);
+			seconds[phase] = instructions[phase] = 0;
+			if ((pos = strstr(line, key))) {
+				seconds[phase] = atof(pos + strlen(key));
+				if ((pos = strstr(pos, "\"instructions\": ")))
+					instructions[phase] = atof(pos + strlen("\"instructions\": "));
+			}
+		}
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+/* print_result : print the measures of a case and how they compare to an earlier run
+ * 				  the instructions are the steadier signal on a busy machine
+ * parameters   : result   - a pointer to the measures
+ * 				  baseline - the results file of the earlier run or NULL
+ * return       :*/
+static void print_result(const bench_result *result, FILE *baseline) {
+	double 		 before[NUM_OF_PHASES],
+				 before_instructions[NUM_OF_PHASES];
+	const double *counts;
+	int    		 phase,
+		   		 compare = baseline && find_baseline(baseline, result->name, before,
+				 	 	 	 	 	 	 	 	 	 before_instructions);
+
+	printf("%s: %ld lines, %ld bytes\n", result->name, result->lines, result->bytes);
+	for (phase = 0; phase < NUM_OF_PHASES; phase++) {
+		counts = result->counts[phase];
+		printf("  %-12s %9.4f s %12.0f lines/s %8.2f MB/s  peak rss %8ld KB",
+			   phase_names[phase], result->seconds[phase],
+			   result->lines / result->seconds[phase],
+			   result->bytes / result->seconds[phase] / 1e6,
+			   result->peak_rss_kb[phase]);
+		if (compare && before[phase])
+			printf("  %+6.1f%% time", 100 * (result->seconds[phase] / before[phase] - 1));
+		if (compare && before_instructions[phase] > 0 && counts[INSTRUCTIONS_COUNTER] > 0)
+			printf("  %+6.1f%% instructions", 100 *
+				   (counts[INSTRUCTIONS_COUNTER] / before_instructions[phase] - 1));
+		printf("\n");
+
+		if (counts[CYCLES_COUNTER] > 0 && counts[INSTRUCTIONS_COUNTER] >= 0)
+			printf("  %-12s IPC %5.2f  instructions/line %8.1f", "",
+				   counts[INSTRUCTIONS_COUNTER] / counts[CYCLES_COUNTER],
+				   counts[INSTRUCTIONS_COUNTER] / result->lines);
+		if (counts[CACHE_MISSES_COUNTER] >= 0)
+			printf("  cache misses/line %7.3f", counts[CACHE_MISSES_COUNTER] / result->lines);
+		if (counts[BRANCH_MISSES_COUNTER] >= 0)
+			printf("  branch misses/line %7.3f",
+				   counts[BRANCH_MISSES_COUNTER] / result->lines);
+		if (counts[CYCLES_COUNTER] >= 0)
+			printf("\n");
+	}
+	if (result->counts[PASS1_PHASE][CYCLES_COUNTER] < 0)
+		printf("  hardware counters are not available\n");
+}
+
+/* write_ratio : write a ratio of counts to a results file, null if one of them
+ * 				 isnt available
+ * parameters  : results - the results file
+ * 				 key     - the name of the ratio
+ * 				 a       - the count to divide
+ * 				 b       - the count to divide by
+ * return      :*/
+static void write_ratio(FILE *results, const char *key, const double a, const double b) {
+	if (a >= 0 && b > 0)
+		fprintf(results, ", \"%s\": %.4f", key, a / b);
+	else
+		fprintf(results, ", \"%s\": null", key);
+}
+
+/* write_result : write the measures of a case as a line of a JSON array
+ * parameters   : results - the results file
+ * 				  result  - a pointer to the measures
+ * 				  first   - TRUE if it is the first case in the file
+ * return       :*/
+static void write_result(FILE *results, const bench_result *result, const int first) {
+	const double *counts;
+	double 		 lines = result->lines;
+	int 		 phase,
+				 i;
+
+	fprintf(results, "%s{\"case\": \"%s\", \"lines\": %ld, \"bytes\": %ld",
+			first ? "" : ",\n", result->name, result->lines, result->bytes);
+	for (phase = 0; phase < NUM_OF_PHASES; phase++) {
+		counts = result->counts[phase];
+		fprintf(results, ", \"%s\": {\"seconds\": %.6f, \"lines_per_sec\": %.0f, "
+				"\"bytes_per_sec\": %.0f, \"peak_rss_kb\": %ld", phase_names[phase],
+				result->seconds[phase], result->lines / result->seconds[phase],
+				result->bytes / result->seconds[phase], result->peak_rss_kb[phase]);
+		for (i = 0; i < NUM_OF_COUNTERS; i++)
+			if (counts[i] >= 0)
+				fprintf(results, ", \"%s\": %.0f", counter_names[i], counts[i]);
+			else
+				fprintf(results, ", \"%s\": null", counter_names[i]);
+		write_ratio(results, "ipc", counts[INSTRUCTIONS_COUNTER], counts[CYCLES_COUNTER]);
+		write_ratio(results, "cache_misses_per_line", counts[CACHE_MISSES_COUNTER], lines);
+		write_ratio(results, "branch_misses_per_line", counts[BRANCH_MISSES_COUNTER],
+					lines);
+		fprintf(results, "}");
+	}
+	fprintf(results, "}");
+}
+
+/* entry point
+ * usage : asm_bench [-r repeats] [-o results.json] [-b baseline.json] file...
+ * the files are given by their base name like to the assembler, a baseline that
+ * doesnt exist is ignored*/
+int main(int argc, char **argv) {
+	bench_result result;
+	FILE 		 *results = NULL,
+				 *baseline = NULL;
+	int 		 i,
+				 repeats = DEFAULT_REPEATS,
+				 measured = 0,
+				 failed = 0;
+
+	for (i = 1; i + 1 < argc && argv[i][0] == '-'; i += 2)
+		if (!strcmp(argv[i], "-r"))
+			repeats = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-o")) {
+			if (!(results = fopen(argv[i + 1], WRITE))) {
+				print_error(ERROR_CREATE_FILE, argv[i + 1], 0);
+				return EXIT_FAILURE;
+			}
+		} else if (!strcmp(argv[i], "-b"))
+			baseline = fopen(argv[i + 1], READ);
+		else
+			break;
+
+	if (i == argc || repeats <= 0) {
+		fprintf(stderr, "usage: %s [-r repeats] [-o results.json] [-b baseline.json] "
+				"file...\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (results)
+		fprintf(results, "[\n");
+	for (; i < argc; i++) {
+		if (run_case(argv[i], repeats, &result)) {
+			print_error(result.err_val, argv[i], 0);
+			failed++;
+			continue;
+		}
+		print_result(&result, baseline);
+		if (results)
+			write_result(results, &result, !measured++);
+	}
+	if (results) {
+		fprintf(results, "\n]\n");
+		fclose(results);
+	}
+	if (baseline)
+		fclose(baseline);
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+#include <time.h>
+#include "../encoder.h"
+
+/*the number of words encoded for every image size*/
+#define NUM_OF_WORDS 4000000L
+/*the largest image size to measure*/
+#define MAX_WORDS 1000000L
+/*the size of the blocks of the arena the memory image is allocated from*/
+#define BENCH_ARENA_BLOCK_SIZE (1024 * 1024)
+/*the number of words encoded before they are written, like the object file does*/
+#define CHUNK_WORDS 1024
+
+/* seconds_since : get the time that passed since a given clock
+ * parameters    : start - the clock to measure from
+ * return        : the time in seconds*/
+static double seconds_since(clock_t start) {
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* bench_size : fill the code of a memory image with the given number of words and
+ * 				time encoding it word by word, in chunks, and copying the encoded
+ * 				lines as a bound of what the memory can do
+ * parameters : size - the number of words in the image
+ * return     : NO_ERROR           - if the benchmark ran
+ * 				ERROR_MEMORY_ALLOC - if the image couldnt be allocated*/
+static error_value bench_size(long size) {
+	error_value  err_val = NO_ERROR;
+	arena		 *arena_p;
+	memory_image *mem_img;
+	char 		 *lines,
+				 *copy,
+				 *out,
+				 word[SPECIAL_BASE_WORD_SIZE + 1];
+	unsigned int seed = 1;
+	long 		 i,
+				 rounds = NUM_OF_WORDS / size,
+				 bytes = 0,
+				 r;
+	clock_t 	 start;
+	double		 word_ns,
+				 batch_ns,
+				 copy_ns;
+
+	if (!(arena_p = arena_init(BENCH_ARENA_BLOCK_SIZE)))
+		return ERROR_MEMORY_ALLOC;
+	if (!(mem_img = memory_image_init(arena_p)) ||
+		code_table_reserve(mem_img->code, (int)size) ||
+		!(lines = malloc(size * MAX_OBJECT_LINE_LEN))) {
+		arena_free(arena_p);
+		return ERROR_MEMORY_ALLOC;
+	}
+	if (!(copy = malloc(size * MAX_OBJECT_LINE_LEN))) {
+		free(lines);
+		arena_free(arena_p);
+		return ERROR_MEMORY_ALLOC;
+	}
+
+	/*fill the code with words of every bit pattern*/
+	for (i = 0; !err_val && i < size; i++) {
+		seed = seed * 1103515245U + 12345U;
+		err_val = add_code(mem_img->code, (int)(seed >> 16));
+	}
+
+	/*time the way the object file used to be made, a word at a time*/
+	start = clock();
+	for (r = 0; r < rounds; r++)
+		for (i = 0, out = lines; i < size; i++) {
+			word_to_4_special_base(mem_img->code->words[i], word);
+			out += sprintf(out, "%04d %s\n", (int)i + ADDRESS_OFFSET, word);
+		}
+	word_ns = 1e9 * seconds_since(start) / rounds / size;
+
+	/*time the batch encoder the way the object file uses it, a chunk at a time*/
+	start = clock();
+	for (r = 0; r < rounds; r++)
+		for (i = 0, out = lines; i < size; i += CHUNK_WORDS)
+			out = encode_object_words(mem_img, (int)i,
+					(int)(size - i < CHUNK_WORDS ? size - i : CHUNK_WORDS), out);
+	batch_ns = 1e9 * seconds_since(start) / rounds / size;
+	bytes = out - lines;
+
+	/*time copying the encoded lines, no encoder can write them faster*/
+	start = clock();
+	for (r = 0; r < rounds; r++) {
+		memcpy(copy, lines, bytes);
+		/*read the copy so it isnt optimized away*/
+		lines[r % bytes] = copy[(r * 7) % bytes];
+	}
+	copy_ns = 1e9 * seconds_since(start) / rounds / size;
+
+	/*the memory traffic is what the image and the lines take, read and written*/
+	printf("%8ld words: per word %6.1f ns  batch %5.1f ns (%6.0f MB/s)  "
+		   "copy %5.1f ns (%6.0f MB/s)\n", size, word_ns, batch_ns,
+		   (size * sizeof(machine_word) + bytes) / batch_ns * 1e3 / size, copy_ns,
+		   2 * bytes / copy_ns * 1e3 / size);
+
+	free(copy);
+	free(lines);
+	arena_free(arena_p);
+
+	return err_val;
+}
+
+/* entry point */
+int main() {
+	long size;
+
+	/*measure every image size from a thousand to a million words*/
+	for (size = 1000; size <= MAX_WORDS; size *= 10)
+		if (bench_size(size)) {
+			print_error(ERROR_MEMORY_ALLOC, "encoder_bench", 0);
+			return EXIT_FAILURE;
+		}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,460 @@
+#include "../defs.h"
+#include "../error.h"
+
+/*the kinds of corpus the generator makes*/
+#define MIXED_CORPUS "mixed"
+#define LABELS_CORPUS "labels"
+#define DATA_CORPUS "data"
+
+/*the size of the pathological cases, a label on every line and one long .data list*/
+#define LABELS_CORPUS_LINES 1000000L
+#define DATA_CORPUS_NUMBERS 100000L
+
+/*the most numbers of a .data line and characters of a .string line so every line
+ * fits in MAX_LINE_LEN with the longest label*/
+#define MAX_DATA_PER_LINE 8
+#define MAX_STRING_LEN 40
+/*the numbers are drawn from -NUMBER_RANGE to NUMBER_RANGE*/
+#define NUMBER_RANGE 1000
+/*the values of the macros are small so they can be used as an index*/
+#define MACRO_RANGE 10
+/*the constants of the random number generator and the bits it gives*/
+#define RANDOM_MULTIPLIER 1103515245UL
+#define RANDOM_INCREMENT 12345UL
+#define RANDOM_BITS 15
+/*the seed of the operands is kept apart from the seed of the layout*/
+#define OPERAND_SEED_SALT 0x5bd1e995UL
+
+/* a struct representing what the generated source looks like
+ * every percentage is out of 100*/
+typedef struct{
+	const char *corpus;
+	long lines;
+	int label_pct;
+	int extern_pct;
+	int entry_pct;
+	int num_of_defines;
+	int data_pct;
+	int data_per_line;
+	int string_len;
+	unsigned long seed;
+} corpus_options;
+
+/*a struct representing an operation and the addressing modes it allows*/
+typedef struct{
+	const char *name;
+	int num_of_operands;
+	int src_modes;
+	int dest_modes;
+} gen_op;
+
+/*the operations with the addressing modes the assembler allows for them*/
+static const gen_op gen_ops[] = {
+	{"mov", 2, IMMEDIATE | DIRECT | INDEX | REGISTER, DIRECT | INDEX | REGISTER},
+	{"cmp", 2, IMMEDIATE | DIRECT | INDEX | REGISTER, IMMEDIATE | DIRECT | INDEX | REGISTER},
+	{"add", 2, IMMEDIATE | DIRECT | INDEX | REGISTER, DIRECT | INDEX | REGISTER},
+	{"sub", 2, IMMEDIATE | DIRECT | INDEX | REGISTER, DIRECT | INDEX | REGISTER},
+	{"lea", 2, DIRECT | INDEX, DIRECT | INDEX | REGISTER},
+	{"not", 1, NONE, DIRECT | INDEX | REGISTER},
+	{"clr", 1, NONE, DIRECT | INDEX | REGISTER},
+	{"inc", 1, NONE, DIRECT | INDEX | REGISTER},
+	{"dec", 1, NONE, DIRECT | INDEX | REGISTER},
+	{"jmp", 1, NONE, DIRECT | REGISTER},
+	{"bne", 1, NONE, DIRECT | REGISTER},
+	{"red", 1, NONE, DIRECT | INDEX | REGISTER},
+	{"prn", 1, NONE, IMMEDIATE | DIRECT | INDEX | REGISTER},
+	{"jsr", 1, NONE, DIRECT | REGISTER},
+	{"rts", 0, NONE, NONE},
+	{"stop", 0, NONE, NONE}
+};
+
+/*the number of operations*/
+#define NUM_OF_GEN_OPS ((int)(sizeof(gen_ops) / sizeof(gen_ops[0])))
+
+/*the number of labels of each kind, they are known before the lines are made so
+ * any line can refer to a label defined after it*/
+typedef struct{
+	long code;
+	long data;
+	long externs;
+} label_counts;
+
+/* next_random : advance a random number generator, the same seed always gives the
+ * 				 same numbers on every platform
+ * parameters  : state - a pointer to the state of the generator
+ * return      : a random number of RANDOM_BITS bits*/
+static long next_random(unsigned long *state) {
+	*state = (*state * RANDOM_MULTIPLIER + RANDOM_INCREMENT) & 0xFFFFFFFFUL;
+
+	return (long)((*state >> 16) & ((1UL << RANDOM_BITS) - 1));
+}
+
+/* random_below : draw a random number below a bound
+ * parameters   : state - a pointer to the state of the generator
+ * 				  bound - the bound, more than 0
+ * return       : a random number from 0 to bound - 1*/
+static long random_below(unsigned long *state, long bound) {
+	long high = next_random(state);
+
+	return ((high << RANDOM_BITS) | next_random(state)) % bound;
+}
+
+/* random_number : draw a random number from -range to range
+ * parameters    : state - a pointer to the state of the generator
+ * 				   range - the largest absolute value
+ * return        : the number*/
+static int random_number(unsigned long *state, int range) {
+	return (int)random_below(state, 2L * range + 1) - range;
+}
+
+/* next_line_kind : decide if the next line is a data line and if it has a label
+ * parameters     : opts     - a pointer to the options of the corpus
+ * 					state    - a pointer to the state of the layout generator
+ * 					is_data  - the output for TRUE if the line is a data line
+ * 					labelled - the output for TRUE if the line has a label
+ * return         :*/
+static void next_line_kind(const corpus_options *opts, unsigned long *state,
+						   int *is_data, int *labelled) {
+	*is_data = random_below(state, 100) < opts->data_pct;
+	*labelled = random_below(state, 100) < opts->label_pct;
+}
+
+/* count_labels : count the labels the lines will have by running the layout once
+ * parameters   : opts   - a pointer to the options of the corpus
+ * 				  counts - the output for the number of labels
+ * return       :*/
+static void count_labels(const corpus_options *opts, label_counts *counts) {
+	unsigned long state = opts->seed;
+	long 		  i;
+	int 		  is_data,
+				  labelled;
+
+	counts->code = counts->data = 0;
+	for (i = 0; i < opts->lines; i++) {
+		next_line_kind(opts, &state, &is_data, &labelled);
+		if (labelled) {
+			if (is_data)
+				counts->data++;
+			else
+				counts->code++;
+		}
+	}
+	counts->externs = (counts->code + counts->data) * opts->extern_pct / 100;
+}
+
+/* print_symbol : print the name of a random label or extern
+ * parameters   : counts - a pointer to the number of labels
+ * 				  state  - a pointer to the state of the operand generator
+ * return       :*/
+static void print_symbol(const label_counts *counts, unsigned long *state) {
+	long n = random_below(state, counts->code + counts->data + counts->externs);
+
+	if (n < counts->code)
+		printf("C%ld", n);
+	else if ((n -= counts->code) < counts->data)
+		printf("D%ld", n);
+	else
+		printf("X%ld", n - counts->data);
+}
+
+/* print_operand : print a random operand in one of the given addressing modes
+ * parameters    : modes  - the addressing modes allowed, at least one
+ * 				   opts   - a pointer to the options of the corpus
+ * 				   counts - a pointer to the number of labels
+ * 				   state  - a pointer to the state of the operand generator
+ * return        :*/
+static void print_operand(int modes, const corpus_options *opts,
+						  const label_counts *counts, unsigned long *state) {
+	int mode;
+
+	/*draw modes until one is allowed*/
+	do
+		mode = 1 << random_below(state, 4);
+	while (!(mode & modes));
+
+	switch (mode) {
+	case IMMEDIATE:
+		if (opts->num_of_defines && random_below(state, 4) == 0)
+			printf("#k%ld", random_below(state, opts->num_of_defines));
+		else
+			printf("#%d", random_number(state, NUMBER_RANGE));
+		break;
+	case DIRECT:
+		print_symbol(counts, state);
+		break;
+	case INDEX:
+		print_symbol(counts, state);
+		if (opts->num_of_defines && random_below(state, 2) == 0)
+			printf("[k%ld]", random_below(state, opts->num_of_defines));
+		else
+			printf("[%ld]", random_below(state, MACRO_RANGE));
+		break;
+	default:
+		printf("r%ld", random_below(state, 8));
+	}
+}
+
+/* print_instruction : print a random instruction whose operands can be made
+ * parameters        : opts   - a pointer to the options of the corpus
+ * 					   counts - a pointer to the number of labels
+ * 					   state  - a pointer to the state of the operand generator
+ * return            :*/
+static void print_instruction(const corpus_options *opts, const label_counts *counts,
+							  unsigned long *state) {
+	const gen_op *op;
+	int 		 symbol_modes = counts->code + counts->data + counts->externs ?
+								DIRECT | INDEX : NONE;
+
+	/*without labels an operation that needs one is drawn again*/
+	do
+		op = &gen_ops[random_below(state, NUM_OF_GEN_OPS)];
+	while ((op->num_of_operands == 2 && !((op->src_modes & ~(DIRECT | INDEX)) |
+										  (op->src_modes & symbol_modes))) ||
+		   (op->num_of_operands && !((op->dest_modes & ~(DIRECT | INDEX)) |
+									 (op->dest_modes & symbol_modes))));
+
+	printf("%s", op->name);
+	if (op->num_of_operands == 2) {
+		printf(" ");
+		print_operand(op->src_modes & (~(DIRECT | INDEX) | symbol_modes), opts, counts,
+					  state);
+		printf(", ");
+	} else if (op->num_of_operands)
+		printf(" ");
+	if (op->num_of_operands)
+		print_operand(op->dest_modes & (~(DIRECT | INDEX) | symbol_modes), opts, counts,
+					  state);
+}
+
+/* print_data : print a random .data or .string directive
+ * parameters : opts  - a pointer to the options of the corpus
+ * 				state - a pointer to the state of the operand generator
+ * return     :*/
+static void print_data(const corpus_options *opts, unsigned long *state) {
+	long i,
+		 len;
+
+	if (opts->string_len && random_below(state, 2) == 0) {
+		printf(".string \"");
+		for (i = 0, len = random_below(state, opts->string_len + 1); i < len; i++)
+			putchar('a' + (int)random_below(state, 26));
+		printf("\"");
+	} else {
+		printf(".data ");
+		for (i = 0, len = 1 + random_below(state, opts->data_per_line); i < len; i++) {
+			if (i)
+				printf(", ");
+			if (opts->num_of_defines && random_below(state, 8) == 0)
+				printf("k%ld", random_below(state, opts->num_of_defines));
+			else
+				printf("%d", random_number(state, NUMBER_RANGE));
+		}
+	}
+}
+
+/* print_entries : print an .entry line for an even spread of the labels
+ * parameters    : opts   - a pointer to the options of the corpus
+ * 				   counts - a pointer to the number of labels
+ * return        :*/
+static void print_entries(const corpus_options *opts, const label_counts *counts) {
+	long i;
+
+	/*a label is an entry when the share of entries grows past a whole number*/
+	for (i = 0; i < counts->code + counts->data; i++)
+		if ((i + 1) * opts->entry_pct / 100 != i * opts->entry_pct / 100) {
+			if (i < counts->code)
+				printf(".entry C%ld\n", i);
+			else
+				printf(".entry D%ld\n", i - counts->code);
+		}
+}
+
+/* generate_mixed : print a source of code and data lines, the macros and the
+ * 					externs come first and the entries last
+ * parameters     : opts - a pointer to the options of the corpus
+ * return         :*/
+static void generate_mixed(const corpus_options *opts) {
+	unsigned long layout = opts->seed,
+				  operands = opts->seed ^ OPERAND_SEED_SALT;
+	label_counts  counts;
+	long 		  i,
+				  code_label = 0,
+				  data_label = 0;
+	int 		  is_data,
+				  labelled;
+
+	count_labels(opts, &counts);
+
+	printf("; generated corpus, %ld lines, seed %lu\n", opts->lines, opts->seed);
+	for (i = 0; i < opts->num_of_defines; i++)
+		printf(".define k%ld = %ld\n", i, random_below(&operands, MACRO_RANGE));
+	for (i = 0; i < counts.externs; i++)
+		printf(".extern X%ld\n", i);
+
+	for (i = 0; i < opts->lines; i++) {
+		next_line_kind(opts, &layout, &is_data, &labelled);
+		if (labelled) {
+			if (is_data)
+				printf("D%ld: ", data_label++);
+			else
+				printf("C%ld: ", code_label++);
+		}
+		if (is_data)
+			print_data(opts, &operands);
+		else
+			print_instruction(opts, &counts, &operands);
+		printf("\n");
+	}
+
+	print_entries(opts, &counts);
+}
+
+/* generate_data_list : print one .data list of many numbers split over as many lines
+ * 						as it takes, and code that indexes into it
+ * parameters         : opts - a pointer to the options of the corpus
+ * return             :*/
+static void generate_data_list(const corpus_options *opts) {
+	unsigned long state = opts->seed;
+	long 		  i;
+
+	printf("; generated data list, %ld numbers, seed %lu\n", opts->lines, opts->seed);
+	printf(".entry LIST\n");
+	printf("MAIN: mov LIST[%d], r1\n", MACRO_RANGE - 1);
+	printf("lea LIST, r2\n");
+	printf("stop\n");
+
+	/*a line cant hold the whole list so the label is on its first line only*/
+	for (i = 0; i < opts->lines; i++) {
+		if (i % MAX_DATA_PER_LINE == 0)
+			printf(i ? "\n.data " : "LIST: .data ");
+		else
+			printf(", ");
+		printf("%d", random_number(&state, NUMBER_RANGE));
+	}
+	printf("\n");
+}
+
+/* set_corpus : set the options to the defaults of a kind of corpus
+ * parameters : opts   - a pointer to the options
+ * 				corpus - the kind of corpus
+ * return     : NO_ERROR    - if the kind of corpus is known
+ * 				SYNTAX_ERROR - else*/
+static error_value set_corpus(corpus_options *opts, const char *corpus) {
+	opts->corpus = corpus;
+	opts->lines = 100000;
+	opts->label_pct = 25;
+	opts->extern_pct = 10;
+	opts->entry_pct = 10;
+	opts->num_of_defines = 10;
+	opts->data_pct = 20;
+	opts->data_per_line = MAX_DATA_PER_LINE;
+	opts->string_len = 20;
+
+	if (!strcmp(corpus, LABELS_CORPUS)) {
+		opts->lines = LABELS_CORPUS_LINES;
+		opts->label_pct = 100;
+	} else if (!strcmp(corpus, DATA_CORPUS))
+		opts->lines = DATA_CORPUS_NUMBERS;
+	else if (strcmp(corpus, MIXED_CORPUS))
+		return SYNTAX_ERROR;
+
+	return NO_ERROR;
+}
+
+/* parse_percent : parse a percentage option
+ * parameters    : arg - the argument of the option
+ * 				   pct - the output for the percentage
+ * return        : NO_ERROR     - if it is a number from 0 to 100
+ * 				   SYNTAX_ERROR - else*/
+static error_value parse_percent(const char *arg, int *pct) {
+	*pct = atoi(arg);
+
+	return *pct < 0 || *pct > 100 ? SYNTAX_ERROR : NO_ERROR;
+}
+
+/* parse_options : parse the options of the generator, each option is a letter and
+ * 				   its value in the next argument, the options after -c override
+ * 				   the defaults of the corpus it chooses
+ * parameters    : argc - the number of arguments
+ * 				   argv - the arguments
+ * 				   opts - the output for the options
+ * return        : NO_ERROR     - if the options are valid
+ * 				   SYNTAX_ERROR - else*/
+static error_value parse_options(int argc, char **argv, corpus_options *opts) {
+	error_value err_val;
+	int 		i;
+
+	err_val = set_corpus(opts, MIXED_CORPUS);
+	opts->seed = 1;
+
+	for (i = 1; !err_val && i < argc; i += 2) {
+		if (argv[i][0] != '-' || !argv[i][1] || argv[i][2] || i + 1 == argc)
+			return SYNTAX_ERROR;
+
+		switch (argv[i][1]) {
+		case 'c':
+			err_val = set_corpus(opts, argv[i + 1]);
+			break;
+		case 'n':
+			err_val = (opts->lines = atol(argv[i + 1])) < 0 ? SYNTAX_ERROR : NO_ERROR;
+			break;
+		case 'l':
+			err_val = parse_percent(argv[i + 1], &opts->label_pct);
+			break;
+		case 'x':
+			err_val = parse_percent(argv[i + 1], &opts->extern_pct);
+			break;
+		case 'e':
+			err_val = parse_percent(argv[i + 1], &opts->entry_pct);
+			break;
+		case 'v':
+			err_val = parse_percent(argv[i + 1], &opts->data_pct);
+			break;
+		case 'd':
+			err_val = (opts->num_of_defines = atoi(argv[i + 1])) < 0 ?
+					  SYNTAX_ERROR : NO_ERROR;
+			break;
+		case 'w':
+			opts->data_per_line = atoi(argv[i + 1]);
+			err_val = opts->data_per_line < 1 || opts->data_per_line > MAX_DATA_PER_LINE ?
+					  SYNTAX_ERROR : NO_ERROR;
+			break;
+		case 's':
+			opts->string_len = atoi(argv[i + 1]);
+			err_val = opts->string_len < 0 || opts->string_len > MAX_STRING_LEN ?
+					  SYNTAX_ERROR : NO_ERROR;
+			break;
+		case 'r':
+			opts->seed = strtoul(argv[i + 1], NULL, 10);
+			break;
+		default:
+			err_val = SYNTAX_ERROR;
+		}
+	}
+
+	return err_val;
+}
+
+/* entry point
+ * usage : gen_corpus [-c mixed|labels|data] [-n lines] [-l label%] [-x extern%]
+ * 					  [-e entry%] [-d defines] [-v data%] [-w numbers per .data]
+ * 					  [-s string length] [-r seed]
+ * the source is printed to the standard output, for the data corpus -n is the
+ * number of numbers in the list*/
+int main(int argc, char **argv) {
+	corpus_options opts;
+
+	if (parse_options(argc, argv, &opts)) {
+		fprintf(stderr, "usage: %s [-c mixed|labels|data] [-n lines] [-l label%%] "
+				"[-x extern%%] [-e entry%%] [-d defines] [-v data%%] "
+				"[-w numbers per .data] [-s string length] [-r seed]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (!strcmp(opts.corpus, DATA_CORPUS))
+		generate_data_list(&opts);
+	else
+		generate_mixed(&opts);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,698 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <time.h>
+#include "../context.h"
+#include "../source.h"
+#include "../pass1.h"
+#include "../pass2.h"
+#include "../encoder.h"
+#include "../utils.h"
+#include "../file_handler.h"
+
+/*the most lines of the source the inputs are taken from, spread over the file*/
+#define MAX_SAMPLES 512
+/*the most names looked up in the symbol tables*/
+#define MAX_LOOKUPS (4 * MAX_SAMPLES)
+/*the most words of the memory image that are encoded*/
+#define MAX_WORDS 4096
+/*the least number of calls in a batch, a batch is timed as a whole so the clock is
+ * read far less often than the functions are called*/
+#define MIN_BATCH_CALLS 4096
+/*the number of lines prepared before they are parsed, few enough to stay in cache*/
+#define PARSE_CHUNK 64
+/*the number of batches that are timed and that are run before them by default*/
+#define DEFAULT_REPEATS 200
+#define DEFAULT_WARMUP 20
+/*the size of the blocks of the arena the inputs are allocated from*/
+#define BENCH_ARENA_BLOCK_SIZE (64 * 1024)
+/*the longest line of a results file*/
+#define MAX_RESULT_LINE_LEN 256
+
+/*a name looked up in a symbol table, the label of a line is looked up before it is
+ * added so it is looked up in a table without the labels*/
+typedef struct{
+	const char *name;
+	symtable *table;
+} symbol_lookup;
+
+/* a struct representing the inputs of the benchmarks, they are taken from a real
+ * assembly of a source file so they are spread like the calls of the assembler
+ * context holds the file after both passes and macros holds only its macros, the
+ * table the lines are parsed with since every line is parsed as if it was new
+ * lines are the sampled lines parsed and texts are the lines before they were
+ * parsed, labels, operands, data lines and parameter lines point into lines
+ * sink keeps what the functions return so the calls cant be left out*/
+typedef struct{
+	assembly_context *context;
+	arena *arena;
+	symtable *macros;
+	char (*texts)[SCAN_LINE_SIZE];
+	int *text_lens;
+	parsed_line *lines;
+	int num_of_lines;
+	parsed_line *chunk;
+	symbol_lookup *lookups;
+	int num_of_lookups;
+	const char **labels;
+	symbol_type *label_types;
+	int num_of_labels;
+	char **operands;
+	int num_of_operands;
+	parsed_line **data_lines;
+	int num_of_data_lines;
+	parsed_line **param_lines;
+	int num_of_param_lines;
+	int *words;
+	int num_of_words;
+	long sink;
+} bench_inputs;
+
+/*a function that times one batch of calls and gives the time of a call in ns*/
+typedef error_value (*bench_batch)(bench_inputs*, double*);
+
+/*a struct representing a function that is measured, inputs is the offset of the
+ * number of its inputs in bench_inputs*/
+typedef struct{
+	const char *name;
+	bench_batch batch;
+	size_t inputs;
+} bench_case;
+
+/* now_seconds : read a clock that only goes forward
+ * parameters  :
+ * return      : the time in seconds from a fixed point in the past*/
+static double now_seconds() {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* rounds_for : get the number of times a batch goes over its inputs
+ * parameters : num_of_inputs - the number of inputs, more than 0
+ * return     : the least number of rounds that make MIN_BATCH_CALLS calls*/
+static long rounds_for(const int num_of_inputs) {
+	return (MIN_BATCH_CALLS + num_of_inputs - 1) / num_of_inputs;
+}
+
+/* prepare_line : copy a line to a parsed line and pre-scan it like the first pass
+ * 				  does before it parses it
+ * parameters   : line - a pointer to the parsed line
+ * 				  text - the text of the line
+ * 				  len  - the length of the text
+ * return       :*/
+static void prepare_line(parsed_line *line, const char *text, const int len) {
+	reset_parsed_line(line);
+	memcpy(line->line, text, len);
+	line->line[len] = '\0';
+	scan_line(line->line, len, &line->scan);
+}
+
+/* batch_find_symbol : time looking up the labels of the lines before they are added
+ * 					   and the symbols of the operands and of the data
+ * parameters        : in - a pointer to the inputs
+ * 					   ns - the output for the time of a call in ns
+ * return            : NO_ERROR*/
+static error_value batch_find_symbol(bench_inputs *in, double *ns) {
+	long   rounds = rounds_for(in->num_of_lookups),
+		   r;
+	int    i;
+	double start = now_seconds();
+
+	for (r = 0; r < rounds; r++)
+		for (i = 0; i < in->num_of_lookups; i++)
+			in->sink += find_symbol(in->lookups[i].name, in->lookups[i].table) != NULL;
+	*ns = 1e9 * (now_seconds() - start) / (rounds * in->num_of_lookups);
+
+	return NO_ERROR;
+}
+
+/* batch_add_symbol : time adding the labels of the lines to a new symbol table, the
+ * 					  table grows like it does in the first pass
+ * parameters       : in - a pointer to the inputs
+ * 					  ns - the output for the time of a call in ns
+ * return           : NO_ERROR           - if the batch ran
+ * 					  ERROR_MEMORY_ALLOC - if a table couldnt be allocated*/
+static error_value batch_add_symbol(bench_inputs *in, double *ns) {
+	error_value err_val = NO_ERROR;
+	arena		*arena_p;
+	symtable	*symtable_p;
+	long   		rounds = rounds_for(in->num_of_labels),
+		   		r;
+	int    		i;
+	double 		seconds = 0,
+				start;
+
+	if (!(arena_p = arena_init(BENCH_ARENA_BLOCK_SIZE)))
+		return ERROR_MEMORY_ALLOC;
+
+	for (r = 0; !err_val && r < rounds; r++) {
+		arena_reset(arena_p);
+		if (!(symtable_p = symtable_init(arena_p))) {
+			err_val = ERROR_MEMORY_ALLOC;
+			break;
+		}
+		start = now_seconds();
+		for (i = 0; !err_val && i < in->num_of_labels; i++)
+			err_val = add_symbol(symtable_p, in->labels[i], i, in->label_types[i]);
+		seconds += now_seconds() - start;
+	}
+	*ns = 1e9 * seconds / (rounds * in->num_of_labels);
+	arena_free(arena_p);
+
+	return err_val;
+}
+
+/* batch_get_addr_mode : time classifying the operands of the instructions
+ * parameters          : in - a pointer to the inputs
+ * 						 ns - the output for the time of a call in ns
+ * return              : NO_ERROR*/
+static error_value batch_get_addr_mode(bench_inputs *in, double *ns) {
+	long   rounds = rounds_for(in->num_of_operands),
+		   r;
+	int    i;
+	double start = now_seconds();
+
+	for (r = 0; r < rounds; r++)
+		for (i = 0; i < in->num_of_operands; i++)
+			in->sink += get_addr_mode(in->operands[i], in->context->symtable);
+	*ns = 1e9 * (now_seconds() - start) / (rounds * in->num_of_operands);
+
+	return NO_ERROR;
+}
+
+/* batch_valid_label : time checking the labels of the lines
+ * parameters        : in - a pointer to the inputs
+ * 					   ns - the output for the time of a call in ns
+ * return            : NO_ERROR*/
+static error_value batch_valid_label(bench_inputs *in, double *ns) {
+	long   rounds = rounds_for(in->num_of_labels),
+		   r;
+	int    i;
+	double start = now_seconds();
+
+	for (r = 0; r < rounds; r++)
+		for (i = 0; i < in->num_of_labels; i++)
+			in->sink += valid_label(in->labels[i], in->context->symtable);
+	*ns = 1e9 * (now_seconds() - start) / (rounds * in->num_of_labels);
+
+	return NO_ERROR;
+}
+
+/* batch_is_valid_data_params : time checking the parameters of the data directives
+ * parameters                 : in - a pointer to the inputs
+ * 								ns - the output for the time of a call in ns
+ * return                     : NO_ERROR*/
+static error_value batch_is_valid_data_params(bench_inputs *in, double *ns) {
+	parsed_line *line;
+	long   		rounds = rounds_for(in->num_of_data_lines),
+		   		r;
+	int    		i;
+	double 		start = now_seconds();
+
+	for (r = 0; r < rounds; r++)
+		for (i = 0; i < in->num_of_data_lines; i++) {
+			line = in->data_lines[i];
+			in->sink += is_valid_data_params(line->line, line->params,
+											 line->num_of_params, in->macros);
+		}
+	*ns = 1e9 * (now_seconds() - start) / (rounds * in->num_of_data_lines);
+
+	return NO_ERROR;
+}
+
+/* batch_get_num_of_params : time counting the parameters of the instructions and of
+ * 							 the data directives
+ * parameters              : in - a pointer to the inputs
+ * 							 ns - the output for the time of a call in ns
+ * return                  : NO_ERROR*/
+static error_value batch_get_num_of_params(bench_inputs *in, double *ns) {
+	long   rounds = rounds_for(in->num_of_param_lines),
+		   r;
+	int    i;
+	double start = now_seconds();
+
+	for (r = 0; r < rounds; r++)
+		for (i = 0; i < in->num_of_param_lines; i++)
+			in->sink += get_num_of_params(in->param_lines[i]);
+	*ns = 1e9 * (now_seconds() - start) / (rounds * in->num_of_param_lines);
+
+	return NO_ERROR;
+}
+
+/* batch_parse_line : time parsing the lines, the parser terminates the tokens in
+ * 					  place so the lines are prepared again a chunk at a time and only
+ * 					  the parsing is timed
+ * parameters       : in - a pointer to the inputs
+ * 					  ns - the output for the time of a call in ns
+ * return           : NO_ERROR*/
+static error_value batch_parse_line(bench_inputs *in, double *ns) {
+	long   rounds = rounds_for(in->num_of_lines),
+		   r;
+	int    i,
+		   j,
+		   len;
+	double seconds = 0,
+		   start;
+
+	for (r = 0; r < rounds; r++)
+		for (i = 0; i < in->num_of_lines; i += PARSE_CHUNK) {
+			len = in->num_of_lines - i < PARSE_CHUNK ? in->num_of_lines - i : PARSE_CHUNK;
+			for (j = 0; j < len; j++)
+				prepare_line(&in->chunk[j], in->texts[i + j], in->text_lens[i + j]);
+			start = now_seconds();
+			for (j = 0; j < len; j++)
+				in->sink += parse_line(&in->chunk[j], in->macros);
+			seconds += now_seconds() - start;
+		}
+	*ns = 1e9 * seconds / (rounds * in->num_of_lines);
+
+	return NO_ERROR;
+}
+
+/* batch_word_to_4_special_base : time translating the words of the memory image
+ * parameters                   : in - a pointer to the inputs
+ * 								  ns - the output for the time of a call in ns
+ * return                       : NO_ERROR*/
+static error_value batch_word_to_4_special_base(bench_inputs *in, double *ns) {
+	char   word[SPECIAL_BASE_WORD_SIZE + 1];
+	long   rounds = rounds_for(in->num_of_words),
+		   r;
+	int    i;
+	double start = now_seconds();
+
+	for (r = 0; r < rounds; r++)
+		for (i = 0; i < in->num_of_words; i++) {
+			word_to_4_special_base(in->words[i], word);
+			in->sink += word[0];
+		}
+	*ns = 1e9 * (now_seconds() - start) / (rounds * in->num_of_words);
+
+	return NO_ERROR;
+}
+
+/*the functions that are measured*/
+static const bench_case bench_cases[] = {
+	{"find_symbol", batch_find_symbol, offsetof(bench_inputs, num_of_lookups)},
+	{"add_symbol", batch_add_symbol, offsetof(bench_inputs, num_of_labels)},
+	{"get_addr_mode", batch_get_addr_mode, offsetof(bench_inputs, num_of_operands)},
+	{"valid_label", batch_valid_label, offsetof(bench_inputs, num_of_labels)},
+	{"is_valid_data_params", batch_is_valid_data_params,
+	 offsetof(bench_inputs, num_of_data_lines)},
+	{"get_num_of_params", batch_get_num_of_params,
+	 offsetof(bench_inputs, num_of_param_lines)},
+	{"parse_line", batch_parse_line, offsetof(bench_inputs, num_of_lines)},
+	{"word_to_4_special_base", batch_word_to_4_special_base,
+	 offsetof(bench_inputs, num_of_words)}
+};
+
+/*the number of functions that are measured*/
+#define NUM_OF_CASES ((int)(sizeof(bench_cases) / sizeof(bench_cases[0])))
+
+/* num_of_inputs : get the number of inputs of a function
+ * parameters    : in    - a pointer to the inputs
+ * 				   index - the index of the function in bench_cases
+ * return        : the number of inputs, a function without inputs isnt measured*/
+static int num_of_inputs(const bench_inputs *in, const int index) {
+	return *(const int *)((const char *)in + bench_cases[index].inputs);
+}
+
+/* take       : allocate memory for the inputs
+ * parameters : in   - a pointer to the inputs
+ * 				size - the number of bytes to allocate
+ * return     : a pointer to the memory or NULL if allocation failed*/
+static void *take(bench_inputs *in, const size_t size) {
+	return arena_alloc(in->arena, ARENA_OTHER, size);
+}
+
+/* add_lookup : add a name to look up to the inputs if there is room for it
+ * parameters : in    - a pointer to the inputs
+ * 				name  - the name, it is kept
+ * 				table - the table it is looked up in
+ * return     :*/
+static void add_lookup(bench_inputs *in, const char *name, symtable *table) {
+	if (in->num_of_lookups < MAX_LOOKUPS) {
+		in->lookups[in->num_of_lookups].name = name;
+		in->lookups[in->num_of_lookups++].table = table;
+	}
+}
+
+/* add_line_inputs : add what a parsed line gives to the inputs of the functions
+ * parameters      : in   - a pointer to the inputs
+ * 					 line - a pointer to the line, it is kept
+ * return          : NO_ERROR           - if the inputs were added
+ * 					 ERROR_MEMORY_ALLOC - if a symbol name couldnt be allocated*/
+static error_value add_line_inputs(bench_inputs *in, parsed_line *line) {
+	directive_id directive = line->keyword ? line->keyword->directive : NO_DIRECTIVE;
+	char 		 *param,
+				 *symbol;
+	int 		 i;
+
+	/*the label of an entry or an extern line is ignored by the first pass*/
+	if (*line->label && directive != ENTRY_DIRECTIVE && directive != EXTERN_DIRECTIVE) {
+		in->label_types[in->num_of_labels] = line->type == DIRECTIVE_TYPE ? DATA : CODE;
+		in->labels[in->num_of_labels++] = line->label;
+		add_lookup(in, line->label, in->macros);
+	}
+
+	if (line->type == INSTRUCTION_TYPE || directive == DATA_DIRECTIVE)
+		in->param_lines[in->num_of_param_lines++] = line;
+	if (directive == DATA_DIRECTIVE)
+		in->data_lines[in->num_of_data_lines++] = line;
+
+	for (i = 0; i < line->num_of_params; i++) {
+		if (!line->params[i].len)
+			continue;
+		param = line->line + line->params[i].offset;
+		/*a macro in the data is looked up while it is checked*/
+		if (directive == DATA_DIRECTIVE) {
+			if (!is_legal_number(param))
+				add_lookup(in, param, in->macros);
+			continue;
+		}
+		if (line->type != INSTRUCTION_TYPE)
+			continue;
+		in->operands[in->num_of_operands++] = param;
+		/*the label of an operand is looked up in the second pass without its index*/
+		switch (get_addr_mode(param, in->context->symtable)) {
+		case DIRECT:
+		case INDEX:
+			if (!(symbol = arena_strndup(in->arena, ARENA_OTHER, param,
+										 strcspn(param, "["))))
+				return ERROR_MEMORY_ALLOC;
+			add_lookup(in, symbol, in->context->symtable);
+			break;
+		default:
+			break;
+		}
+	}
+
+	return NO_ERROR;
+}
+
+/* sample_lines : parse lines spread evenly over a source file and take the inputs
+ * 				  of the functions from them, the empty and the comment lines and the
+ * 				  lines that dont parse on their own (the macro definitions) are left
+ * 				  out
+ * parameters   : in        - a pointer to the inputs
+ * 				  file_name - the name of the source file
+ * return       : NO_ERROR - if the lines were sampled
+ * 				  else the error opening the file or allocating*/
+static error_value sample_lines(bench_inputs *in, const char *file_name) {
+	error_value err_val;
+	source_file source;
+	line_slice  slice;
+	parsed_line *line;
+	long 		num_of_lines,
+				stride,
+				i;
+
+	if ((err_val = source_open(&source, file_name)))
+		return err_val;
+	for (num_of_lines = 0; source_next_line(&source, &slice); num_of_lines++);
+	source_close(&source);
+	stride = num_of_lines / MAX_SAMPLES + 1;
+
+	if ((err_val = source_open(&source, file_name)))
+		return err_val;
+	for (i = 0; !err_val && in->num_of_lines < MAX_SAMPLES &&
+		 source_next_line(&source, &slice); i++) {
+		if (i % stride)
+			continue;
+		line = &in->lines[in->num_of_lines];
+		prepare_line(line, slice.text, slice.len);
+		if (line_valid(line->line, &line->scan) || is_empty_line(&line->scan) ||
+			is_comment_line(&line->scan) || parse_line(line, in->macros))
+			continue;
+		memcpy(in->texts[in->num_of_lines], slice.text, slice.len);
+		in->text_lens[in->num_of_lines++] = slice.len;
+		err_val = add_line_inputs(in, line);
+	}
+	source_close(&source);
+
+	return err_val;
+}
+
+/* sample_words : take words spread evenly over the memory image, the code and then
+ * 				  the data like the object file has them
+ * parameters   : in - a pointer to the inputs
+ * return       :*/
+static void sample_words(bench_inputs *in) {
+	memory_image *mem_img = in->context->mem_img;
+	long 		 size = (long)mem_img->code->ic + mem_img->data->dc,
+				 stride = size / MAX_WORDS + 1,
+				 i;
+
+	for (i = 0; i < size && in->num_of_words < MAX_WORDS; i += stride)
+		in->words[in->num_of_words++] = i < mem_img->code->ic ?
+										mem_img->code->words[i] :
+										mem_img->data->words[i - mem_img->code->ic];
+}
+
+/* assemble_source : assemble a file through both passes so its symbol table and
+ * 					 memory image are complete, nothing is written
+ * parameters      : context   - a pointer to the assembly context to use
+ * 					 file_name - the name of the source file
+ * return          : NO_ERROR - if the file was assembled
+ * 					 else the error of the file*/
+static error_value assemble_source(assembly_context *context, const char *file_name) {
+	error_value err_val;
+	diagnostics diag;
+	source_file source;
+
+	if ((err_val = source_open(&source, file_name)))
+		return err_val;
+	diagnostics_init(&diag);
+	context->diag = &diag;
+
+	if (!(err_val = context_reset(context)) &&
+		!(err_val = memory_image_reserve(context->mem_img, source.size)) &&
+		!(err_val = pass1_execute(&source, context, file_name))) {
+		pass2_prep(context);
+		err_val = pass2_execute(context, file_name);
+	}
+
+	context->diag = NULL;
+	diagnostics_flush(&diag);
+	source_close(&source);
+
+	return err_val;
+}
+
+/* load_inputs : assemble a file and take the inputs of the functions from it
+ * parameters  : in        - a pointer to the inputs
+ * 				 file_base - the base name of the file
+ * return      : NO_ERROR - if the inputs are ready
+ * 				 else the error of the file or of allocating*/
+static error_value load_inputs(bench_inputs *in, const char *file_base) {
+	error_value    err_val;
+	symtable_entry *entry;
+	char 		   *file_name;
+	int 		   i;
+
+	if (!(file_name = new_file_name(file_base, CODE_FILE_EXT)))
+		return ERROR_MEMORY_ALLOC;
+
+	if (!(in->context = context_init()) ||
+		!(in->arena = arena_init(BENCH_ARENA_BLOCK_SIZE)))
+		err_val = ERROR_MEMORY_ALLOC;
+	else
+		err_val = assemble_source(in->context, file_name);
+
+	if (!err_val && (!(in->macros = symtable_init(in->arena)) ||
+		!(in->texts = take(in, MAX_SAMPLES * sizeof(*in->texts))) ||
+		!(in->text_lens = take(in, MAX_SAMPLES * sizeof(int))) ||
+		!(in->lines = take(in, MAX_SAMPLES * sizeof(parsed_line))) ||
+		!(in->chunk = take(in, PARSE_CHUNK * sizeof(parsed_line))) ||
+		!(in->lookups = take(in, MAX_LOOKUPS * sizeof(symbol_lookup))) ||
+		!(in->labels = take(in, MAX_SAMPLES * sizeof(char *))) ||
+		!(in->label_types = take(in, MAX_SAMPLES * sizeof(symbol_type))) ||
+		!(in->operands = take(in, 2 * MAX_SAMPLES * sizeof(char *))) ||
+		!(in->data_lines = take(in, MAX_SAMPLES * sizeof(parsed_line *))) ||
+		!(in->param_lines = take(in, MAX_SAMPLES * sizeof(parsed_line *))) ||
+		!(in->words = take(in, MAX_WORDS * sizeof(int)))))
+		err_val = ERROR_MEMORY_ALLOC;
+
+	/*the lines are parsed with the macros already defined like the first pass has
+	 * them when it gets to the line*/
+	for (i = 0; !err_val && i < in->context->symtable->table_size; i++) {
+		entry = &in->context->symtable->symtable_entries[i];
+		if (entry->type == MACRO)
+			err_val = add_symbol(in->macros, entry->name, entry->value, MACRO);
+	}
+
+	if (!err_val && !(err_val = sample_lines(in, file_name)))
+		sample_words(in);
+	free(file_name);
+
+	return err_val;
+}
+
+/* free_inputs : free the inputs of the functions
+ * parameters  : in - a pointer to the inputs
+ * return      :*/
+static void free_inputs(bench_inputs *in) {
+	if (in->arena)
+		arena_free(in->arena);
+	if (in->context)
+		context_free(in->context);
+}
+
+/* compare_doubles : compare two numbers for qsort
+ * parameters      : a - a pointer to the first number
+ * 					 b - a pointer to the second number
+ * return          : negative, zero or positive like strcmp*/
+static int compare_doubles(const void *a, const void *b) {
+	double x = *(const double *)a,
+		   y = *(const double *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/* find_baseline : find the median time of a function in the results of an earlier run
+ * parameters    : baseline - the results file of the earlier run
+ * 				   name     - the name of the function
+ * return        : the median time in ns or 0 if the function isnt there*/
+static double find_baseline(FILE *baseline, const char *name) {
+	char 	   line[MAX_RESULT_LINE_LEN],
+			   key[MAX_RESULT_LINE_LEN];
+	const char *pos;
+
+	/*every function is on a line of its own*/
+	rewind(baseline);
+	sprintf(key, "{\"case\": \"%s\"", name);
+	while (fgets(line, sizeof(line), baseline))
+		if (!strncmp(line, key, strlen(key)) &&
+			(pos = strstr(line, "\"median_ns\": ")))
+			return atof(pos + strlen("\"median_ns\": "));
+
+	return 0;
+}
+
+/* run_case   : run the batches of a function, the warmup batches arent kept, and
+ * 				print the median and the 99th percentile of the time of a call
+ * parameters : in       - a pointer to the inputs
+ * 				index    - the index of the function in bench_cases
+ * 				warmup   - the number of batches run before the timed ones
+ * 				repeats  - the number of batches that are timed
+ * 				times    - room for the times of the batches
+ * 				results  - the results file or NULL
+ * 				baseline - the results file of an earlier run or NULL
+ * 				first    - TRUE if it is the first function in the results file
+ * return     : NO_ERROR - if the function was measured
+ * 				else the error of a batch*/
+static error_value run_case(bench_inputs *in, const int index, const int warmup,
+							const int repeats, double *times, FILE *results,
+							FILE *baseline, const int first) {
+	error_value err_val = NO_ERROR;
+	const char  *name = bench_cases[index].name;
+	double 		median,
+				p99,
+				before = 0;
+	int 		i;
+
+	for (i = 0; !err_val && i < warmup + repeats; i++)
+		err_val = bench_cases[index].batch(in, &times[i < warmup ? 0 : i - warmup]);
+	if (err_val)
+		return err_val;
+
+	qsort(times, repeats, sizeof(double), compare_doubles);
+	median = times[repeats / 2];
+	p99 = times[(repeats - 1) * 99 / 100];
+
+	printf("  %-24s %6d inputs %9.2f ns median %9.2f ns p99", name,
+		   num_of_inputs(in, index), median, p99);
+	if (baseline && (before = find_baseline(baseline, name)))
+		printf("  %+6.1f%%", 100 * (median / before - 1));
+	printf("\n");
+
+	if (results)
+		fprintf(results, "%s{\"case\": \"%s\", \"inputs\": %d, \"median_ns\": %.3f, "
+				"\"p99_ns\": %.3f}", first ? "" : ",\n", name, num_of_inputs(in, index),
+				median, p99);
+
+	return NO_ERROR;
+}
+
+/* is_selected : check if a function was asked for
+ * parameters  : name         - the name of the function
+ * 				 names        - the names asked for
+ * 				 num_of_names - the number of names, 0 asks for all the functions
+ * return      : TRUE if the function is measured else FALSE*/
+static int is_selected(const char *name, char **names, const int num_of_names) {
+	int i;
+
+	for (i = 0; i < num_of_names; i++)
+		if (!strcmp(name, names[i]))
+			return TRUE;
+
+	return num_of_names ? FALSE : TRUE;
+}
+
+/* entry point
+ * usage : micro_bench [-r repeats] [-w warmup] [-o results.json] [-b baseline.json]
+ * 		   file [function...]
+ * the file is given by its base name like to the assembler and the inputs are taken
+ * from it, without functions all of them are measured*/
+int main(int argc, char **argv) {
+	error_value  err_val = NO_ERROR;
+	bench_inputs in;
+	FILE 		 *results = NULL,
+				 *baseline = NULL;
+	const char	 *file_base;
+	double 		 *times = NULL;
+	int 		 i,
+				 c,
+				 repeats = DEFAULT_REPEATS,
+				 warmup = DEFAULT_WARMUP,
+				 measured = 0;
+
+	for (i = 1; i + 1 < argc && argv[i][0] == '-'; i += 2)
+		if (!strcmp(argv[i], "-r"))
+			repeats = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-w"))
+			warmup = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-o")) {
+			if (!(results = fopen(argv[i + 1], WRITE))) {
+				print_error(ERROR_CREATE_FILE, argv[i + 1], 0);
+				return EXIT_FAILURE;
+			}
+		} else if (!strcmp(argv[i], "-b"))
+			baseline = fopen(argv[i + 1], READ);
+		else
+			break;
+
+	if (i == argc || argv[i][0] == '-' || repeats <= 0 || warmup < 0) {
+		fprintf(stderr, "usage: %s [-r repeats] [-w warmup] [-o results.json] "
+				"[-b baseline.json] file [function...]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	file_base = argv[i++];
+	memset(&in, 0, sizeof(bench_inputs));
+	if (!(times = malloc((warmup + repeats) * sizeof(double))))
+		err_val = ERROR_MEMORY_ALLOC;
+	else if (!(err_val = load_inputs(&in, file_base)))
+		printf("%s: %d lines sampled\n", file_base, in.num_of_lines);
+
+	if (results)
+		fprintf(results, "[\n");
+	for (c = 0; !err_val && c < NUM_OF_CASES; c++)
+		if (is_selected(bench_cases[c].name, argv + i, argc - i) && num_of_inputs(&in, c))
+			err_val = run_case(&in, c, warmup, repeats, times, results, baseline,
+							   !measured++);
+	if (results) {
+		fprintf(results, "\n]\n");
+		fclose(results);
+	}
+	if (baseline)
+		fclose(baseline);
+
+	if (err_val)
+		print_error(err_val, file_base, 0);
+	free_inputs(&in);
+	free(times);
+
+	return err_val ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+#include <time.h>
+#include "../symtable.h"
+
+/*the number of lookups timed for every table size*/
+#define NUM_OF_LOOKUPS 2000000L
+/*the largest table size to measure*/
+#define MAX_SYMBOLS 1000000L
+/*the size of the blocks of the arena the symbol table is allocated from*/
+#define BENCH_ARENA_BLOCK_SIZE (1024 * 1024)
+/*a prime used to visit the symbols in a scattered order*/
+#define STRIDE_PRIME 7919L
+
+/* make_name  : make the name of the n-th generated symbol
+ * parameters : n        - the number of the symbol
+ * 				name_out - the output for the name
+ * return     :*/
+static void make_name(long n, char *name_out) {
+	sprintf(name_out, "Sym%ld", n);
+}
+
+/* bench_size : fill a symbol table with the given number of symbols and time
+ * 				hits and misses looking them up
+ * parameters : size - the number of symbols in the table
+ * return     : NO_ERROR           - if the benchmark ran
+ * 				ERROR_MEMORY_ALLOC - if the table couldnt be allocated*/
+static error_value bench_size(long size) {
+	error_value err_val = NO_ERROR;
+	arena		*arena_p;
+	symtable 	*symtable_p;
+	char 		(*names)[MAX_LABEL_LEN + 1];
+	char 		miss[MAX_LABEL_LEN + 1];
+	long 		i,
+				found = 0;
+	clock_t 	start;
+	double		add_ns,
+				hit_ns,
+				miss_ns;
+
+	if (!(arena_p = arena_init(BENCH_ARENA_BLOCK_SIZE)))
+		return ERROR_MEMORY_ALLOC;
+	if (!(symtable_p = symtable_init(arena_p)) ||
+		!(names = malloc(size * sizeof(*names)))) {
+		arena_free(arena_p);
+		return ERROR_MEMORY_ALLOC;
+	}
+
+	for (i = 0; i < size; i++)
+		make_name(i, names[i]);
+
+	/*time adding every symbol*/
+	start = clock();
+	for (i = 0; !err_val && i < size; i++)
+		err_val = add_symbol(symtable_p, names[i], (int)i, CODE);
+	add_ns = 1e9 * (clock() - start) / CLOCKS_PER_SEC / size;
+
+	/*time lookups of existing symbols in a scattered order*/
+	start = clock();
+	for (i = 0; i < NUM_OF_LOOKUPS; i++)
+		found += find_symbol(names[(i * STRIDE_PRIME) % size], symtable_p) != NULL;
+	hit_ns = 1e9 * (clock() - start) / CLOCKS_PER_SEC / NUM_OF_LOOKUPS;
+
+	/*time lookups of a symbol that isnt in the table*/
+	make_name(-1, miss);
+	start = clock();
+	for (i = 0; i < NUM_OF_LOOKUPS; i++)
+		found += find_symbol(miss, symtable_p) != NULL;
+	miss_ns = 1e9 * (clock() - start) / CLOCKS_PER_SEC / NUM_OF_LOOKUPS;
+
+	printf("%8ld symbols: add %7.1f ns  hit %7.1f ns  miss %7.1f ns  (%ld found)\n",
+		   size, add_ns, hit_ns, miss_ns, found);
+
+	free(names);
+	arena_free(arena_p);
+
+	return err_val;
+}
+
+/* entry point */
+int main() {
+	long size;
+
+	/*measure every table size from 100 to a million symbols*/
+	for (size = 100; size <= MAX_SYMBOLS; size *= 10)
+		if (bench_size(size)) {
+			print_error(ERROR_MEMORY_ALLOC, "symtable_bench", 0);
+			return EXIT_FAILURE;
+		}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,264 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#include "cache.h"
+#include "source.h"
+#include "file_handler.h"
+
+/*the longest first line of an entry, the sizes of the output files*/
+#define MAX_HEADER_LEN 64
+/*the permissions of the directory of the cache before the umask*/
+#define CACHE_DIR_MODE 0777
+/*the name of a new entry before it is complete, entries starting with '.' arent
+ * counted*/
+#define TEMP_ENTRY_NAME ".new-XXXXXX"
+/*the number of entries the list of the entries starts with when it is evicted*/
+#define ENTRIES_INIT_CAPACITY 64
+/*the constants of the two hashes of the key, FNV-1a and a multiply and shift mix*/
+#define FNV_OFFSET 2166136261UL
+#define FNV_PRIME 16777619UL
+#define MIX_SEED 0x9747b28cUL
+#define MIX_MULTIPLIER 0x5bd1e995UL
+#define HASH_MASK 0xFFFFFFFFUL
+
+/*an entry of the cache as it is looked at when the cache is too big*/
+typedef struct{
+	char *name;
+	time_t used;
+	long size;
+} cache_entry;
+
+/* hash_bytes : add bytes to the two hashes of a key, they are kept to 32 bits so
+ * 				the key is the same on every platform
+ * parameters : data - the bytes
+ * 				size - the number of bytes
+ * 				hash - the two hashes
+ * return     :*/
+static void hash_bytes(const char *data, const size_t size, unsigned long hash[2]) {
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		hash[0] = ((hash[0] ^ (unsigned char)data[i]) * FNV_PRIME) & HASH_MASK;
+		hash[1] = ((hash[1] ^ (unsigned char)data[i]) * MIX_MULTIPLIER) & HASH_MASK;
+		hash[1] ^= hash[1] >> 15;
+	}
+}
+
+/* cache_key  : make the key of a source, the hashes of the version of the
+ * 				assembler and of the source and the size of the source
+ * parameters : data - the bytes of the source
+ * 				size - the number of bytes
+ * 				key  - the output for the key, CACHE_KEY_LEN characters and a '\0'
+ * return     :*/
+void cache_key(const char *data, const size_t size, char *key) {
+	unsigned long hash[2];
+
+	hash[0] = FNV_OFFSET;
+	hash[1] = MIX_SEED;
+	hash_bytes(ASSEMBLER_VERSION, strlen(ASSEMBLER_VERSION) + 1, hash);
+	hash_bytes(data, size, hash);
+	sprintf(key, "%08lx%08lx%08lx", hash[0], hash[1], (unsigned long)size & HASH_MASK);
+}
+
+/* cache_path : make the name of a file in the directory of a cache
+ * parameters : cache - a pointer to the cache
+ * 				name  - the name of the file in the directory
+ * return     : the allocated name or NULL if it couldnt be allocated*/
+static char *cache_path(const build_cache *cache, const char *name) {
+	char *path;
+
+	if ((path = malloc(strlen(cache->dir) + strlen(name) + 2)))
+		sprintf(path, "%s/%s", cache->dir, name);
+
+	return path;
+}
+
+/* read_header : read the sizes of the output files from the first line of an entry
+ * parameters  : entry - a pointer to the entry as a source file
+ * 				 sizes - the output for the sizes, -1 for a file the entry doesnt have
+ * return      : the length of the first line or 0 if the entry is broken*/
+static size_t read_header(const source_file *entry, long sizes[NUM_OF_OUTPUTS]) {
+	char   header[MAX_HEADER_LEN + 1];
+	size_t len,
+		   total;
+	int    i;
+
+	for (len = 0; len < entry->size && len < MAX_HEADER_LEN && entry->data[len] != '\n';
+		 len++)
+		header[len] = entry->data[len];
+	header[len++] = '\0';
+	if (sscanf(header, "%ld %ld %ld", &sizes[0], &sizes[1], &sizes[2]) != NUM_OF_OUTPUTS)
+		return 0;
+
+	/*the files must fill the rest of the entry exactly*/
+	for (i = 0, total = len; i < NUM_OF_OUTPUTS; i++)
+		if (sizes[i] >= 0)
+			total += sizes[i];
+
+	return total == entry->size ? len : 0;
+}
+
+/* cache_fetch : look up a source in a cache and write its output files from its
+ * 				 entry, the entry is marked as used
+ * parameters  : cache          - a pointer to the cache
+ * 				 key            - the key of the source
+ * 				 file_base      - the base name of the source
+ * 				 keep_unchanged - TRUE to keep the output files that are the same as
+ * 				 				  before
+ * 				 stats          - a pointer to the statistics of the source or NULL
+ * return      : TRUE if the output files were written else FALSE, the source has
+ * 				 to be assembled then*/
+int cache_fetch(const build_cache *cache, const char *key, const char *file_base,
+				const int keep_unchanged, assembly_stats *stats) {
+	source_file  entry;
+	output_bytes outputs[NUM_OF_OUTPUTS];
+	char 		 *path,
+				 *data;
+	long 		 sizes[NUM_OF_OUTPUTS];
+	size_t 		 len;
+	int 		 i,
+				 found = FALSE;
+
+	if (!(path = cache_path(cache, key)))
+		return FALSE;
+
+	if (!source_open(&entry, path)) {
+		if ((len = read_header(&entry, sizes))) {
+			/*the output files are written straight from the entry*/
+			for (i = 0, data = entry.data + len; i < NUM_OF_OUTPUTS; i++) {
+				outputs[i].data = sizes[i] >= 0 ? data : NULL;
+				outputs[i].size = sizes[i] >= 0 ? sizes[i] : 0;
+				data += outputs[i].size;
+			}
+			found = !write_output_files(file_base, outputs, keep_unchanged, stats);
+			/*the time the entry was changed is the time it was used last*/
+			if (found)
+				utime(path, NULL);
+		}
+		source_close(&entry);
+	}
+	free(path);
+
+	return found;
+}
+
+/* compare_entries : compare two entries of a cache by the time they were used for
+ * 					 qsort, the one used earlier first
+ * parameters      : a - a pointer to the first entry
+ * 					 b - a pointer to the second entry
+ * return          : negative, zero or positive like strcmp*/
+static int compare_entries(const void *a, const void *b) {
+	time_t x = ((const cache_entry *)a)->used,
+		   y = ((const cache_entry *)b)->used;
+
+	return x < y ? -1 : x > y;
+}
+
+/* cache_evict : remove the entries of a cache that were used least recently until
+ * 				 the entries take no more than the size of the cache, it lists the
+ * 				 whole cache so it is done once when all the sources were assembled
+ * parameters  : cache - a pointer to the cache
+ * return      :*/
+void cache_evict(const build_cache *cache) {
+	DIR 		  *dir;
+	struct dirent *ent;
+	struct stat   st;
+	cache_entry   *entries = NULL,
+				  *grown;
+	char 		  *path;
+	long 		  total = 0;
+	int 		  num_of_entries = 0,
+				  capacity = 0,
+				  i;
+
+	if (!(dir = opendir(cache->dir)))
+		return;
+
+	/*list the entries with their size and the time they were used last*/
+	while ((ent = readdir(dir))) {
+		if (ent->d_name[0] == '.' || !(path = cache_path(cache, ent->d_name)))
+			continue;
+		if (stat(path, &st) || !S_ISREG(st.st_mode)) {
+			free(path);
+			continue;
+		}
+		if (num_of_entries == capacity) {
+			capacity = capacity ? 2 * capacity : ENTRIES_INIT_CAPACITY;
+			if (!(grown = realloc(entries, capacity * sizeof(cache_entry)))) {
+				free(path);
+				break;
+			}
+			entries = grown;
+		}
+		entries[num_of_entries].name = path;
+		entries[num_of_entries].used = st.st_mtime;
+		entries[num_of_entries++].size = st.st_size;
+		total += st.st_size;
+	}
+	closedir(dir);
+
+	if (total > cache->max_size) {
+		qsort(entries, num_of_entries, sizeof(cache_entry), compare_entries);
+		for (i = 0; i < num_of_entries && total > cache->max_size; i++)
+			if (!unlink(entries[i].name))
+				total -= entries[i].size;
+	}
+
+	for (i = 0; i < num_of_entries; i++)
+		free(entries[i].name);
+	free(entries);
+}
+
+/* write_entry : write the output files of a source to a new entry of a cache
+ * parameters  : fp      - the new entry
+ * 				 outputs - the output files, a file without data isnt in the entry
+ * return      : TRUE if the entry was written else FALSE*/
+static int write_entry(FILE *fp, const output_bytes *outputs) {
+	int i;
+
+	for (i = 0; i < NUM_OF_OUTPUTS; i++)
+		fprintf(fp, "%s%ld", i ? " " : "", outputs[i].data ? (long)outputs[i].size : -1L);
+	fprintf(fp, "\n");
+	for (i = 0; i < NUM_OF_OUTPUTS; i++)
+		if (outputs[i].data && outputs[i].size)
+			fwrite(outputs[i].data, 1, outputs[i].size, fp);
+
+	return !ferror(fp);
+}
+
+/* cache_store : keep the output files of a source that was just assembled in a
+ * 				 cache, the entry is written under a temporary name and renamed so
+ * 				 it is never seen partly written
+ * 				 the cache is only an aid so a failure leaves the entry out
+ * parameters  : cache   - a pointer to the cache
+ * 				 key     - the key of the source
+ * 				 outputs - the output files as they were written, a file the source
+ * 				 		   doesnt have has no data
+ * return      :*/
+void cache_store(const build_cache *cache, const char *key, const output_bytes *outputs) {
+	FILE *fp;
+	char *temp,
+		 *path;
+	int  stored = FALSE,
+		 fd;
+
+	/*the directory is made the first time it is used*/
+	mkdir(cache->dir, CACHE_DIR_MODE);
+	if ((temp = cache_path(cache, TEMP_ENTRY_NAME))) {
+		if ((path = cache_path(cache, key)) && (fd = mkstemp(temp)) >= 0) {
+			if ((fp = fdopen(fd, WRITE))) {
+				stored = write_entry(fp, outputs);
+				stored = !fclose(fp) && stored && !rename(temp, path);
+			} else
+				close(fd);
+			if (!stored)
+				unlink(temp);
+		}
+		free(path);
+		free(temp);
+	}
+}
@@ -0,0 +1,28 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "defs.h"
+#include "error.h"
+#include "stats.h"
+#include "output.h"
+
+/*the length of the key of a source, three 32 bit numbers in hex*/
+#define CACHE_KEY_LEN 24
+/*the most megabytes the entries of a cache take by default*/
+#define DEFAULT_CACHE_SIZE_MB 64
+
+/* a struct representing a build cache, a directory with an entry for every source
+ * that was assembled without errors, named by the key of the source
+ * an entry holds the output files of its source, the entries used least recently
+ * are removed when all of them take more than max_size bytes at the end of a run*/
+typedef struct{
+	const char *dir;
+	long max_size;
+} build_cache;
+
+void cache_key(const char*, const size_t, char*);
+int cache_fetch(const build_cache*, const char*, const char*, const int, assembly_stats*);
+void cache_store(const build_cache*, const char*, const output_bytes*);
+void cache_evict(const build_cache*);
+
+#endif
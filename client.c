@@ -0,0 +1,197 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <signal.h>
+#include <unistd.h>
+#include "defs.h"
+#include "error.h"
+#include "source.h"
+#include "file_handler.h"
+#include "protocol.h"
+
+/*the option to send the text of the sources instead of their paths*/
+#define INLINE_OPTION "--inline"
+/*the option to leave the output files that are the same as before untouched*/
+#define KEEP_UNCHANGED_OPTION "--keep-unchanged"
+
+/* a struct representing the options given to the client
+ * a source is sent inline when the server cant read the files of the client*/
+typedef struct{
+	const char *socket_path;
+	int send_inline;
+	int keep_unchanged;
+} client_options;
+
+/* parse_options : parse the options given before the files
+ * parameters    : argc       - the number of arguments
+ * 				   argv       - the arguments
+ * 				   options    - the output for the options
+ * 				   first_file - the output for the index of the first file
+ * return        : NO_ERROR       - if the options are valid
+ * 				   INVALID_OPTION - if an option is unknown*/
+static error_value parse_options(int argc, char **argv, client_options *options,
+								 int *first_file) {
+	int i;
+
+	options->socket_path = NULL;
+	options->send_inline = FALSE;
+	options->keep_unchanged = FALSE;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++)
+		if (!strcmp(argv[i], INLINE_OPTION))
+			options->send_inline = TRUE;
+		else if (!strcmp(argv[i], KEEP_UNCHANGED_OPTION))
+			options->keep_unchanged = TRUE;
+		else if (!strncmp(argv[i], SOCKET_OPTION, strlen(SOCKET_OPTION)) &&
+				 argv[i][strlen(SOCKET_OPTION)])
+			options->socket_path = argv[i] + strlen(SOCKET_OPTION);
+		else {
+			*first_file = i;
+			return INVALID_OPTION;
+		}
+	*first_file = i;
+
+	return NO_ERROR;
+}
+
+/* full_path  : make the full path of a source so the server finds it from its own
+ * 				directory
+ * parameters : file_name - the name of the source
+ * return     : the allocated path or NULL if it couldnt be made*/
+static char *full_path(const char *file_name) {
+	char *path,
+		 *cwd;
+
+	if (file_name[0] == '/') {
+		if ((path = malloc(strlen(file_name) + 1)))
+			strcpy(path, file_name);
+		return path;
+	}
+
+	if (!(cwd = malloc(MAX_FILE_NAME_LEN)) || !getcwd(cwd, MAX_FILE_NAME_LEN)) {
+		free(cwd);
+		return NULL;
+	}
+	if ((path = malloc(strlen(cwd) + strlen(file_name) + 2)))
+		sprintf(path, "%s/%s", cwd, file_name);
+	free(cwd);
+
+	return path;
+}
+
+/* assemble_remote : send a source to the server, print its errors and write its
+ * 					 output files the way the assembler does
+ * parameters      : fd        - the socket connected to the server
+ * 					 options   - a pointer to the options
+ * 					 file_base - the base name of the source as it was given
+ * return          : NO_ERROR      - if the source was handled, even with errors
+ * 					 ERROR_CONNECT - if the server couldnt handle it*/
+static error_value assemble_remote(int fd, const client_options *options,
+								   const char *file_base) {
+	error_value err_val;
+	asm_request request;
+	asm_reply 	reply;
+	source_file source;
+	char 		*file_name;
+
+	if (!(file_name = new_file_name(file_base, CODE_FILE_EXT))) {
+		print_error(ERROR_MEMORY_ALLOC, file_base, 0);
+		printf("\n");
+		return NO_ERROR;
+	}
+
+	/*a source sent inline is read here, else the server reads it*/
+	request.name = (char *)file_base;
+	if (options->send_inline) {
+		request.kind = REQUEST_TEXT;
+		if ((err_val = source_open(&source, file_name))) {
+			print_error(err_val, file_name, 0);
+			printf("\n");
+			free(file_name);
+			return NO_ERROR;
+		}
+		request.data = source.data;
+		request.size = source.size;
+	} else {
+		request.kind = REQUEST_PATH;
+		request.data = full_path(file_name);
+		request.size = request.data ? strlen(request.data) : 0;
+	}
+
+	if (!request.data) {
+		print_error(ERROR_MEMORY_ALLOC, file_name, 0);
+		printf("\n");
+		err_val = NO_ERROR;
+	} else if (!(err_val = send_request(fd, &request)) &&
+			   !(err_val = recv_reply(fd, &reply))) {
+		/*the output files are written here so they belong to the user*/
+		if (!(err_val = reply.err_val))
+			err_val = write_output_files(file_base, reply.outputs, options->keep_unchanged,
+										 NULL);
+		diagnostics_flush(&reply.diag);
+		print_error(err_val, file_name, 0);
+		printf("\n");
+		reply_free(&reply);
+		err_val = NO_ERROR;
+	} else {
+		print_error(ERROR_CONNECT, file_name, 0);
+		err_val = ERROR_CONNECT;
+	}
+
+	if (options->send_inline)
+		source_close(&source);
+	else
+		free(request.data);
+	free(file_name);
+
+	return err_val;
+}
+
+/* entry point */
+int main(int argc, char **argv) {
+	error_value		 err_val = NO_ERROR;
+	client_options	 options;
+	struct sigaction action;
+	char 			 *default_path = NULL;
+	int 			 i,
+					 first_file,
+					 fd;
+
+	if (parse_options(argc, argv, &options, &first_file)) {
+		print_error(INVALID_OPTION, argv[first_file], 0);
+		return EXIT_FAILURE;
+	}
+
+	/*check if files were provided to procces*/
+	if (argc <= first_file) {
+		print_error(NO_PARAMETERS, 0, 0);
+		return EXIT_FAILURE;
+	}
+
+	/*a server that stops in the middle of a request is reported instead of ending
+	 *the client*/
+	memset(&action, 0, sizeof(action));
+	sigemptyset(&action.sa_mask);
+	action.sa_handler = SIG_IGN;
+	sigaction(SIGPIPE, &action, NULL);
+
+	/*the default socket is only trusted in a directory of the user*/
+	if (!options.socket_path) {
+		if ((err_val = default_socket_path(&default_path, FALSE)) == ERROR_LISTEN)
+			err_val = ERROR_CONNECT;
+		options.socket_path = default_path;
+	}
+	if (err_val || (fd = socket_connect(options.socket_path)) < 0) {
+		print_error(err_val ? err_val : ERROR_CONNECT,
+					options.socket_path ? options.socket_path : DEFAULT_SOCKET_NAME, 0);
+		free(default_path);
+		return EXIT_FAILURE;
+	}
+
+	/*the files are sent one after another on the same connection*/
+	for (i = first_file; !err_val && i < argc; i++)
+		err_val = assemble_remote(fd, &options, argv[i]);
+	close(fd);
+	free(default_path);
+
+	return err_val ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -3,28 +3,35 @@
 
 #include "defs.h"
 #include "error.h"
+#include "arena.h"
 
-/*a struct representing an entry in the code table*/
+/* a struct representing a word that refers to an external symbol
+ * name is what the externals file shows for it, the operand as it was written*/
 typedef struct {
+	const char *name;
 	int address;
-	int bin_machine_code;
-	char extern_name[MAX_LABEL_LEN];
-} code_entry;
+} extern_ref;
 
-/*a struct representing the code table*/
+/* a struct representing the code table
+ * the address of a word is its index + ADDRESS_OFFSET so only the word is kept
+ * the words that refer to external symbols are listed in extern_refs in the
+ * order they were encoded
+ * reallocs counts the times the words grew for the stats*/
 typedef struct {
-	code_entry *code_entries;
+	machine_word *words;
 	int ic;
-	int extern_flag;
+	int capacity;
+	extern_ref *extern_refs;
+	int num_of_extern_refs;
+	int extern_refs_capacity;
+	int reallocs;
+	arena *arena;
 } code_table;
 
-code_table *code_table_init();
-void code_table_free(code_table*);
+code_table *code_table_init(arena*);
 error_value add_code(code_table*, const int);
+error_value code_table_reserve(code_table*, const int);
+error_value add_extern_ref(code_table*, const char*, const int);
 int get_reg_val(const char*);
-int get_op_allowed_dest(const char*);
-int get_op_allowed_src(const char*);
-int get_op_value(const char*);
-int get_op_num_of_params(const char*);
 
 #endif
@@ -0,0 +1,56 @@
+#include "context.h"
+
+/*the size of the blocks of a context arena, big enough for a typical file*/
+#define CONTEXT_ARENA_BLOCK_SIZE (64 * 1024)
+
+/* context_init : allocate an assembly context and its arena
+ * parameters   :
+ * return       : if initialized succesfully return a pointer to the context
+ * 				  else return NULL*/
+assembly_context *context_init() {
+	assembly_context *context;
+
+	/*allocate the context and its arena, the tables are made by context_reset*/
+	if ((context = malloc(sizeof(assembly_context)))) {
+		context->mem_img = NULL;
+		context->symtable = NULL;
+		context->line = NULL;
+		context->diag = NULL;
+		context->stats = NULL;
+
+		if (!(context->arena = arena_init(CONTEXT_ARENA_BLOCK_SIZE))) {
+			free(context);
+			context = NULL;
+		}
+	}
+
+	return context;
+}
+
+/* context_free : free an assembly context and everything allocated from it
+ * parameters   : context - a pointer to an assembly context
+ * return       :*/
+void context_free(assembly_context *context) {
+	if (context) {
+		arena_free(context->arena);
+		free(context);
+	}
+}
+
+/* context_reset : release everything the previous file used and prepare empty
+ * 				   tables for the next file, reusing the memory of the arena
+ * 				   the symbol table counts its lookups only if the stats are printed
+ * parameters    : context - a pointer to an assembly context
+ * return        : NO_ERROR           - if the context is ready
+ * 				   ERROR_MEMORY_ALLOC - if the tables couldnt be allocated*/
+error_value context_reset(assembly_context *context) {
+	arena_reset(context->arena);
+
+	if (!(context->mem_img = memory_image_init(context->arena)) ||
+		!(context->symtable = symtable_init(context->arena)) ||
+		!(context->line = arena_alloc(context->arena, ARENA_PARSER, sizeof(parsed_line))))
+		return ERROR_MEMORY_ALLOC;
+	context->symtable->count_flag = context->stats && context->stats->format != STATS_OFF;
+
+	return NO_ERROR;
+}
@@ -0,0 +1,30 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "defs.h"
+#include "error.h"
+#include "arena.h"
+#include "memory_image.h"
+#include "symtable.h"
+#include "parser.h"
+#include "stats.h"
+
+/* a struct representing the state of assembling one file
+ * everything in it is allocated from its arena so it is released at once when
+ * the file is done and the context is reset for the next file
+ * the errors of the file are reported to diag and its statistics are kept in stats
+ * when they were asked for*/
+typedef struct{
+	arena *arena;
+	diagnostics *diag;
+	assembly_stats *stats;
+	memory_image *mem_img;
+	symtable *symtable;
+	parsed_line *line;
+} assembly_context;
+
+assembly_context *context_init();
+void context_free(assembly_context*);
+error_value context_reset(assembly_context*);
+
+#endif
@@ -1,19 +1,24 @@
 #include "data.h"
 #include "symtable.h"
 #include "error.h"
+#include "utils.h"
 
-/*the number of directives*/
-#define NUM_OF_DIRECTIVES 4
-/*max length of a directives name*/
-#define MAX_DIRECTIVE_LEN 8
+/*the number of entries a new data table has room for*/
+#define DATA_TABLE_INIT_CAPACITY 64
 
-/*a table of all the directives*/
-static char directive_table[NUM_OF_DIRECTIVES][MAX_DIRECTIVE_LEN] = {
-		"data",
-		"string",
-		"extern",
-		"entry"
-};
+/* make_room  : make sure the data table has room for the given number of new entries
+ * 				growing it at least to twice its size so appending stays amortized
+ * parameters : data_table_p - a pointer to a data table
+ * 				count        - the number of entries about to be added
+ * return     : NO_ERROR           - if the table has room for the entries
+ * 				ERROR_MEMORY_ALLOC - if there was an error allocating the entries*/
+static error_value make_room(data_table *data_table_p, const int count) {
+	int needed = data_table_p->dc + count;
+
+	return needed <= data_table_p->capacity ? NO_ERROR :
+		   data_table_reserve(data_table_p, needed > 2 * data_table_p->capacity ?
+				   	   	   	   	   	   	    needed : 2 * data_table_p->capacity);
+}
 
 /* add_data   : add a data entry to the data table
  * parameters : data_table_p - a pointer to a data table
@@ -22,99 +27,123 @@ static char directive_table[NUM_OF_DIRECTIVES][MAX_DIRECTIVE_LEN] = {
  * 				ERROR_MEMORY_ALLOC - if there was an error allocating the
  * 									 the new entry*/
 static error_value add_data(data_table *data_table_p, const int value) {
-	error_value err_val = NO_ERROR;
-
-	/*if is not the first entry to the data table the increase its size by one*/
-	if(data_table_p->dc)
-		data_table_p->data_entries = realloc(data_table_p->data_entries,
-				(data_table_p->dc + 1) * sizeof(data_entry));
-
-	/* if successfully allocated the table array
-	 * set the dc of the data entry as the current table size
-	 * and set the value as the received parameter*/
-	if (data_table_p) {
-		data_table_p->data_entries[data_table_p->dc].address = data_table_p->dc;
-		data_table_p->data_entries[data_table_p->dc].value = value;
+	error_value err_val = make_room(data_table_p, 1);
+
+	/* if there is room in the table array set the word to the bits of the received
+	 * value, its address follows from its index*/
+	if (!err_val) {
+		data_table_p->words[data_table_p->dc] = (machine_word)(value & WORD_MASK);
 		/*incremet the ic (we use it as a the size of the table too*/
 		data_table_p->dc++;
-	} else /*if allocation has failed*/
-		err_val = ERROR_MEMORY_ALLOC;
+	}
 
 	return err_val;
 }
 
-/* data_table_init : a function to allcate memory for the data talbe and initialize it
- * parameters      :
+/* data_table_init : a function to allcate memory for the data talbe from an arena
+ * 					 and initialize it
+ * parameters      : arena_p - a pointer to the arena that owns the table
  * return          : if initialized succsessfully the return a pointer to the initialized
  * 					 table
  * 					 else return NULL
  */
-data_table *data_table_init() {
+data_table *data_table_init(arena *arena_p) {
 	data_table *data_table_p;
 
 	/*allocate memory and check if succsessfully allocated
 	 * then initialize the variables of the table*/
-	if ((data_table_p = malloc(sizeof(data_table)))){
+	if ((data_table_p = arena_alloc(arena_p, ARENA_DATA, sizeof(data_table)))){
 		data_table_p->dc = 0;
-		data_table_p->data_entries = malloc(sizeof(data_entry));
+		data_table_p->capacity = DATA_TABLE_INIT_CAPACITY;
+		data_table_p->reallocs = 0;
+		data_table_p->arena = arena_p;
+
+		/*if the entries couldnt be allocated the table cant be used*/
+		if (!(data_table_p->words = arena_alloc(arena_p, ARENA_DATA,
+				DATA_TABLE_INIT_CAPACITY * sizeof(machine_word))))
+			data_table_p = NULL;
 	}
 
 	/*return the pointer to the table or NULL if allocation failed*/
 	return data_table_p;
 }
 
-/* data_table_free : free the previously allocated data table
- * parameters     :
- * return         :
- */
-void data_table_free(data_table *data_table_p) {
-	free(data_table_p->data_entries);
-	free(data_table_p);
+/* data_table_reserve : make sure the data table has room for at least the given
+ * 						number of entries without reallocating
+ * parameters         : data_table_p - a pointer to a data table
+ * 						capacity     - the number of entries to make room for
+ * return             : NO_ERROR           - if the table has room for the entries
+ * 						ERROR_MEMORY_ALLOC - if there was an error allocating the entries*/
+error_value data_table_reserve(data_table *data_table_p, const int capacity) {
+	error_value  err_val = NO_ERROR;
+	machine_word *words;
+
+	/*only grow the table, the current entries must stay*/
+	if (capacity > data_table_p->capacity) {
+		if ((words = arena_realloc(data_table_p->arena, ARENA_DATA,
+				data_table_p->words, data_table_p->capacity * sizeof(machine_word),
+				capacity * sizeof(machine_word)))) {
+			data_table_p->words = words;
+			data_table_p->capacity = capacity;
+			data_table_p->reallocs++;
+		} else
+			err_val = ERROR_MEMORY_ALLOC;
+	}
+
+	return err_val;
 }
 
-/* add_string_data : add a string to the data table character by character
+/* add_string_data : add a string to the data table in one step
  * parameters      : data_table_p - a pointer to a data table
  * 					 str - the string to add to the table
  * return          : NO_ERROR           - if string added successfully
  * 				     ERROR_MEMORY_ALLOC - if a problem occured allocatin an
  * 				     					  entry to the table*/
 error_value add_string_data(data_table *data_table_p, const char *str) {
-	error_value err_val = NO_ERROR;
-	int			i,
-			    len = strlen(str);
-
-	/*add every character from str*/
-	for (i = 1; !err_val && i < len - 1; i++)
-		err_val = add_data(data_table_p, str[i]);
-
-	/*add 0 terminator*/
-	if (!err_val)
-		err_val = add_data(data_table_p, '\0');
+	error_value  err_val;
+	machine_word *word;
+	/*the number of characters between the quotes*/
+	int			 i,
+			     len = strlen(str) > 2 ? strlen(str) - 2 : 0;
+
+	/*make room for every character and the 0 terminator and copy them all*/
+	if (!(err_val = make_room(data_table_p, len + 1))) {
+		word = data_table_p->words + data_table_p->dc;
+		for (i = 0; i <= len; i++, word++)
+			*word = i < len ? (machine_word)(str[i + 1] & WORD_MASK) : 0;
+		data_table_p->dc += len + 1;
+	}
 
 	return err_val;
 }
 
-/* add_num_data : add numbers to the data table number by number
- * parameters   : data_table_p - a pointer to a data table
- * 				  params       - the string of numbers to add to the table
- * 				  symtable_p   - a pointer to a symbol table for macros
+/* add_num_data : add numbers to the data table, making room for all of them at once
+ * parameters   : data_table_p  - a pointer to a data table
+ * 				  line          - the line the numbers are in
+ * 				  params        - the comma separated numbers to add to the table
+ * 				  num_of_params - the number of comma separated numbers
+ * 				  symtable_p    - a pointer to a symbol table for macros
  * return       : NO_ERROR              - if string added successfully
  * 				  ERROR_MEMORY_ALLOC    - if a problem occured allocatin an
  * 				      		              entry to the table
  * 				  MACRO_PARAM_UNDEFINED - if an undefined macro has been passed as a number*/
-error_value add_num_data(data_table *data_table_p, char *params,
-						 symtable *symtable_p) {
-	error_value    err_val = NO_ERROR;
+error_value add_num_data(data_table *data_table_p, const char *line, const token *params,
+						 const int num_of_params, symtable *symtable_p) {
+	error_value    err_val = make_room(data_table_p, num_of_params);
 	symtable_entry *sym_entry;
-	int            data_value;
-	/*get the first number*/
-	char           *param = strtok(params, PARSING_DATA_NUM_PARAMS_TOKENS);
+	int            data_value,
+				   i;
+	const char     *param;
 
 	/*get all the numbers and add them to the data table*/
-	for (; !err_val && param;
-			param = strtok(NULL, PARSING_DATA_NUM_PARAMS_TOKENS)) {
+	for (i = 0; !err_val && i < num_of_params; i++) {
+		/*an empty parameter between two commas is skipped*/
+		if (!params[i].len)
+			continue;
+		param = line + params[i].offset;
+
 		/*check if it is a number*/
-		if (isdigit(param[0]) || param[0] == '+' || param[0] == '-')
+		if (char_is(param[0], CHAR_DIGIT | CHAR_SIGN))
 			data_value = atoi(param);
 		/* if not a number then it is a macro, find it*/
 		else if ((sym_entry = find_symbol(param, symtable_p)))
@@ -130,34 +159,3 @@ error_value add_num_data(data_table *data_table_p, char *params,
 
 	return err_val;
 }
-
-/* update_data_addr : update the address of all teh data entries by ic + the address offset
- * 			          we assume the program runs from
- * parameters       : data_table_p - a pointer to a data table
- * 					  ic           - the ic to add to the addresses
- * return 		    :
- */
-void update_data_addr(data_table *data_table_p, const int ic) {
-	int i;
-
-	/*itterate over the data table and update the address of every entry*/
-	if (data_table_p->data_entries) {
-		for (i = 0; i < data_table_p->dc; i++)
-			data_table_p->data_entries[i].address += (ADDRESS_OFFSET + ic);
-	}
-}
-
-/* valid_directive : check if a string is a valid directive
- * parameters      : str - the string to check
- * return          :INVALID_DIRECTIVE - if the string is not a valid directive
- * 					NO_ERROR 		  - if the string is a valid directive*/
-error_value valid_directive(const char *str){
-	int 	   i;
-	const char *p = str + 1;
-
-	/*find the string in the directives table*/
-	for(i = 0; strcmp(p, directive_table[i]) && i < NUM_OF_DIRECTIVES; i++);
-
-	/*if found return NO ERROR else return INVALID_DIRECTIVE*/
-	return i == NUM_OF_DIRECTIVES ? INVALID_DIRECTIVE : NO_ERROR;
-}
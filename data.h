@@ -3,25 +3,24 @@
 
 #include "defs.h"
 #include "symtable.h"
-#include "data.h"
+#include "arena.h"
+#include "lexer.h"
 
-/*a struct representing an entry of the data table*/
+/* a struct representing the data table
+ * the data follows the code so the address of a word is its index + ic +
+ * ADDRESS_OFFSET and only the word is kept
+ * reallocs counts the times the words grew for the stats*/
 typedef struct{
-	int address;
-	int value;
-} data_entry;
-
-/*a struct representing the data table*/
-typedef struct{
-	data_entry *data_entries;
+	machine_word *words;
 	int dc;
+	int capacity;
+	int reallocs;
+	arena *arena;
 }data_table;
 
-data_table *data_table_init();
-void data_table_free(data_table*);
+data_table *data_table_init(arena*);
+error_value data_table_reserve(data_table*, const int);
 error_value add_string_data(data_table*, const char*);
-error_value add_num_data(data_table*, char*, symtable*);
-void update_data_addr(data_table*, const int);
-error_value valid_directive(const char*);
+error_value add_num_data(data_table*, const char*, const token*, const int, symtable*);
 
 #endif
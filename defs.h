@@ -7,6 +7,9 @@
 #include <ctype.h>
 #include <stddef.h>
 
+/*the version of the assembler, it changes whenever the output of a source may change*/
+#define ASSEMBLER_VERSION "1.0"
+
 /*boolean expresions*/
 #define TRUE 1
 #define FALSE 0
@@ -16,6 +19,11 @@
 
 /*the size of a memory word*/
 #define WORD_SIZE 14
+/*a mask of the bits of a memory word*/
+#define WORD_MASK ((1 << WORD_SIZE) - 1)
+
+/*a memory word as it is kept in the memory image, the bits above WORD_SIZE are 0*/
+typedef unsigned short machine_word;
 
 /*max length of a label*/
 #define MAX_LABEL_LEN 31
@@ -29,12 +37,10 @@
 /*the address offset we assumbe the program starts from*/
 #define ADDRESS_OFFSET 100
 
-/*parsing tokens for strtok*/
+/*characters that separate the tokens of a line*/
 #define PARSING_WHITESPACE_TOKENS " \t\n\r"
 #define PARSING_MACRO_TOKENS " ="
 #define PARSING_END_OF_LINE_TOKENS "\n\r"
-#define PARSING_DATA_NUM_PARAMS_TOKENS " ,\n\t\r"
-#define PARSING_PARAMS_TOKENS " ,\n\t\r"
 
 /*addressing mode for bitwise operators use*/
 typedef enum{
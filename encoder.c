@@ -1,14 +1,19 @@
 #include "encoder.h"
 #include "utils.h"
-
-/*the base we encode in*/
-#define BASE_SIZE 4
-/*a mask to held encoding the words*/
-#define BASE_MASK 3
-/*the size of the encoded word*/
-#define SPECIAL_BASE_WORD_SIZE 7
-/*amount to shift the encoding word*/
-#define BASE_MOVE 2
+#include "output.h"
+
+/*the number of special base digits an entry of the digits table holds*/
+#define DIGITS_PER_ENTRY 4
+/*the number of bits of a word an entry of the digits table translates*/
+#define BITS_PER_ENTRY 8
+/*a mask of the bits of a word the low entry translates*/
+#define LOW_ENTRY_MASK ((1U << BITS_PER_ENTRY) - 1)
+/*a mask of the bits of a word the high entry translates*/
+#define HIGH_ENTRY_MASK ((1U << (WORD_SIZE - BITS_PER_ENTRY)) - 1)
+/*the number of special base digits the high entry adds*/
+#define HIGH_DIGITS (SPECIAL_BASE_WORD_SIZE - DIGITS_PER_ENTRY)
+/*the first address that has more than ADDRESS_DIGITS digits*/
+#define FIRST_LONG_ADDRESS 10000
 
 /*enum for the value of the addressing modes*/
 typedef enum{
@@ -25,237 +30,378 @@ typedef enum{
 	EXT = 1
 }coding_mode;
 
-/*a table of the special 4 base characters */
-static char special_base_table[BASE_SIZE + 1] = "*#%!";
-
-/* encode_immediate : a function to encode a parameter with IMMEDIATE addressign mode
- * parameters       : mem_img    - a poitner to a memory image
- *                    symtable_p - a pointer to a symbol table
- *                    token      - the parameter to encode
- * return           :*/
-static void encode_immediate(memory_image *mem_img, symtable *symtable_p, const char *token){
-	int value = 0,
-		word = 0;
-
-	/*if the parameter is a number of a macro get the value to encode accordingly*/
-	value = isalpha(token[1]) ?
-			find_symbol(token + 1, symtable_p)->value : atoi(token + 1);
-	/*encode the value and the coding mode*/
-	word = word | encode_dest_mode(value);
-	word = word | ABS;
-
-	/*update the reserved space in the code table to the encoded word*/
-	mem_img->code->code_entries[mem_img->code->ic].bin_machine_code = word;
-	mem_img->code->ic++;
-}
-
-/* encode_direct : a function to encode and add a parameter with DIRECT addressing mode
- * 				   to the code table
- * parameters    : mem_img    - a pointer to a memory image
- * 			       symtable_p - a pointer to a symbol table
- * 			       token      - the parameter to encode
- * return        : NO_ERROR    - if no error occured
- * 				   LABEL_UNDEF - if a parameter is an undefined label*/
-static error_value encode_direct(memory_image *mem_img, symtable *symtable_p, const char *token){
-	error_value    err_val = NO_ERROR;
-	symtable_entry *sym;
-	coding_mode    c_mode;
-	int            value = 0,
-				   word = 0;
-
-	/*check if the label is defined*/
-	if (!(sym = find_symbol(token, symtable_p)))
-		err_val = LABEL_UNDEF;
-
-	/*if the label is defined*/
-	if (!err_val) {
-		/*check if the label is external*/
-		if (sym->type == EXTERNAL) {
-			/*if its external the flag it as external and encode it a such*/
-			c_mode = EXT;
-			strcpy(mem_img->code->code_entries[mem_img->code->ic].extern_name,
-					token);
-			mem_img->code->extern_flag = TRUE;
-		} else {
-			/*if its not external get its value */
-			value = sym->value;
-			c_mode = RELOC;
-		}
+/* a table of the special 4 base digits of every byte, the digits of a word are two
+ * lookups, its low byte and the 3 last digits of the bits above it*/
+static const char digits_table[1 << BITS_PER_ENTRY][DIGITS_PER_ENTRY] = {
+	"****", "***#", "***%", "***!", "**#*", "**##", "**#%", "**#!",
+	"**%*", "**%#", "**%%", "**%!", "**!*", "**!#", "**!%", "**!!",
+	"*#**", "*#*#", "*#*%", "*#*!", "*##*", "*###", "*##%", "*##!",
+	"*#%*", "*#%#", "*#%%", "*#%!", "*#!*", "*#!#", "*#!%", "*#!!",
+	"*%**", "*%*#", "*%*%", "*%*!", "*%#*", "*%##", "*%#%", "*%#!",
+	"*%%*", "*%%#", "*%%%", "*%%!", "*%!*", "*%!#", "*%!%", "*%!!",
+	"*!**", "*!*#", "*!*%", "*!*!", "*!#*", "*!##", "*!#%", "*!#!",
+	"*!%*", "*!%#", "*!%%", "*!%!", "*!!*", "*!!#", "*!!%", "*!!!",
+	"#***", "#**#", "#**%", "#**!", "#*#*", "#*##", "#*#%", "#*#!",
+	"#*%*", "#*%#", "#*%%", "#*%!", "#*!*", "#*!#", "#*!%", "#*!!",
+	"##**", "##*#", "##*%", "##*!", "###*", "####", "###%", "###!",
+	"##%*", "##%#", "##%%", "##%!", "##!*", "##!#", "##!%", "##!!",
+	"#%**", "#%*#", "#%*%", "#%*!", "#%#*", "#%##", "#%#%", "#%#!",
+	"#%%*", "#%%#", "#%%%", "#%%!", "#%!*", "#%!#", "#%!%", "#%!!",
+	"#!**", "#!*#", "#!*%", "#!*!", "#!#*", "#!##", "#!#%", "#!#!",
+	"#!%*", "#!%#", "#!%%", "#!%!", "#!!*", "#!!#", "#!!%", "#!!!",
+	"%***", "%**#", "%**%", "%**!", "%*#*", "%*##", "%*#%", "%*#!",
+	"%*%*", "%*%#", "%*%%", "%*%!", "%*!*", "%*!#", "%*!%", "%*!!",
+	"%#**", "%#*#", "%#*%", "%#*!", "%##*", "%###", "%##%", "%##!",
+	"%#%*", "%#%#", "%#%%", "%#%!", "%#!*", "%#!#", "%#!%", "%#!!",
+	"%%**", "%%*#", "%%*%", "%%*!", "%%#*", "%%##", "%%#%", "%%#!",
+	"%%%*", "%%%#", "%%%%", "%%%!", "%%!*", "%%!#", "%%!%", "%%!!",
+	"%!**", "%!*#", "%!*%", "%!*!", "%!#*", "%!##", "%!#%", "%!#!",
+	"%!%*", "%!%#", "%!%%", "%!%!", "%!!*", "%!!#", "%!!%", "%!!!",
+	"!***", "!**#", "!**%", "!**!", "!*#*", "!*##", "!*#%", "!*#!",
+	"!*%*", "!*%#", "!*%%", "!*%!", "!*!*", "!*!#", "!*!%", "!*!!",
+	"!#**", "!#*#", "!#*%", "!#*!", "!##*", "!###", "!##%", "!##!",
+	"!#%*", "!#%#", "!#%%", "!#%!", "!#!*", "!#!#", "!#!%", "!#!!",
+	"!%**", "!%*#", "!%*%", "!%*!", "!%#*", "!%##", "!%#%", "!%#!",
+	"!%%*", "!%%#", "!%%%", "!%%!", "!%!*", "!%!#", "!%!%", "!%!!",
+	"!!**", "!!*#", "!!*%", "!!*!", "!!#*", "!!##", "!!#%", "!!#!",
+	"!!%*", "!!%#", "!!%%", "!!%!", "!!!*", "!!!#", "!!!%", "!!!!"
+};
+
+/* encode_symbol_word : a function to encode a word that refers to a symbol
+ * parameters         : code_table_p - a pointer to a code table
+ * 						word_index   - the index of the word in the code table
+ * 						sym          - the symbol the word refers to
+ * 						extern_name  - the name to write to the externals file if the
+ * 									   symbol is external
+ * return             : NO_ERROR           - if no error occured
+ * 						ERROR_MEMORY_ALLOC - if there was an error listing the word as
+ * 											 a reference to an external symbol*/
+static error_value encode_symbol_word(code_table *code_table_p, const int word_index,
+									  symtable_entry *sym, const char *extern_name){
+	error_value err_val = NO_ERROR;
+	coding_mode c_mode;
+	int 		value = 0,
+				word = 0;
+
+	/*check if the label is external*/
+	if (sym->type == EXTERNAL) {
+		/*if its external then list the word for the externals file and encode it a such*/
+		c_mode = EXT;
+		err_val = add_extern_ref(code_table_p, extern_name, word_index + ADDRESS_OFFSET);
+	} else {
+		/*if its not external get its value */
+		value = sym->value;
+		c_mode = RELOC;
+	}
 
-		/*encode the value of label and its coding mode */
-		word = word | encode_dest_mode(value);
-		word = word | c_mode;
+	/*encode the value of label and its coding mode */
+	word = word | encode_dest_mode(value);
+	word = word | c_mode;
 
-		/*update the reserved word in the code table to the enoded value*/
-		mem_img->code->code_entries[mem_img->code->ic].bin_machine_code = word;
-		strcpy(mem_img->code->code_entries[mem_img->code->ic].extern_name,
-			   token);
-		mem_img->code->ic++;
-	}
+	/*update the word in the code table to the enoded value*/
+	code_table_p->words[word_index] = (machine_word)(word & WORD_MASK);
 
 	return err_val;
 }
 
-/* encode_index : encode and add a parameter with INDEX addressing mode to the code table
- * parameters   : mem_img    - a pointer to a memory image
- * 		   	      symtable_p - a pointer to a symbol table
- * 		   	      token      - the parameter to encode
- * return       : NO_ERRRO    - if no error occured
- * 				  LABEL_UNDEF - if a label in the parameters is undefined  */
-static error_value encode_index(memory_image *mem_img, symtable *symtable_p, const char *token){
-	error_value    err_val = NO_ERROR;
-	char 		   arr[MAX_LABEL_LEN];
-	symtable_entry *sym;
-	coding_mode    c_mode;
-	int 		   word = 0,
-				   value = 0;
-
-	/*get the name of the array*/
-	get_arr_name(token, arr);
-
-	/*check if its is defined */
-	if (!(sym = find_symbol(arr, symtable_p)))
-		err_val = LABEL_UNDEF;
-
-	/*if the name is defined*/
-	if (!err_val) {
-		/*check if its external*/
-		if (sym->type == EXTERNAL) {
-			c_mode = EXT;
-			strcpy(mem_img->code->code_entries[mem_img->code->ic].extern_name,
-					token);
-			mem_img->code->extern_flag = TRUE;
-		} else {
-			value = sym->value;
-			c_mode = RELOC;
-		}
-
-		/*encode the value of the array name*/
-		word = word | encode_dest_mode(value);
-		word = word | c_mode;
-
-		/*update the encoded value of the name to the code table*/
-		mem_img->code->code_entries[mem_img->code->ic].bin_machine_code = word;
-		strcpy(mem_img->code->code_entries[mem_img->code->ic].extern_name,
-				token);
-		mem_img->code->ic++;
-
-		word = 0;
-
-		/*get the index of the array*/
-		get_arr_index(token, arr);
-
-		/*check if its a number or a macro and get the value accordingly*/
-		value = isalpha(arr[0]) ?
-				find_symbol(arr, symtable_p)->value : atoi(arr);
-
-		/*encode the value in the word*/
-		word = word | encode_dest_mode(value);
-		word = word | ABS;
-
-		/*update the reserverd code word in the code table with the encoded value*/
-		mem_img->code->code_entries[mem_img->code->ic].bin_machine_code = word;
-		mem_img->code->ic++;
-	}
+/* encode_symbol : a function to add a word that refers to a symbol to the code table
+ * 				   if the symbol already has its final value the word is encoded now
+ * 				   else the operand is left pending to be encoded after the first pass
+ * parameters    : operand    - a pointer to the decoded operand
+ * 				   symtable_p - a pointer to a symbol table
+ * 			       code       - a pointer to a code table
+ * return        : NO_ERROR           - if no error occured
+ * 				   ERROR_MEMORY_ALLOC - if there was an error allocating the word*/
+static error_value encode_symbol(decoded_operand *operand, symtable *symtable_p,
+								 code_table *code){
+	error_value    err_val;
+	symtable_entry *sym = find_symbol(operand->symbol, symtable_p);
+
+	/* data labels move after the code once the first pass is done, other labels
+	 * may be defined later in the file and an external label turns into an entry
+	 * if an .entry line before this one names it*/
+	operand->word = code->ic;
+	operand->pending = !sym || sym->type == DATA || sym->type == EXTERNAL;
+
+	/*add the word and if the symbol is final encode it right away*/
+	if (!(err_val = add_code(code, 0)) && !operand->pending)
+		err_val = encode_symbol_word(code, operand->word, sym, operand->extern_name);
 
 	return err_val;
 }
 
 /* encode_register : a functio to encode and add a parameter with REGISTER addressing mode
  *                   to the code table
- * parameters      : mem_img  - a pointer to a memory image
- * 					 token    - the parameter to encode
- * 					 reg_flag - a flag if a register was encoded in the previous line
- * return          : */
-static void encode_register(memory_image *mem_img, const char *token, const int reg_flag, const int num_of_param){
-	int word = 0;
+ * parameters      : code         - a pointer to a code table
+ * 					 reg          - the number of the register
+ * 					 reg_flag     - a flag if the previous parameter was a register
+ * 					 num_of_param - the number of the parameter in the line
+ * return          : NO_ERROR           - if no error occured
+ * 					 ERROR_MEMORY_ALLOC - if there was an error allocating the word*/
+static error_value encode_register(code_table *code, const int reg,
+								   const int reg_flag, const int num_of_param){
+	error_value err_val = NO_ERROR;
 
 	/*encoded by the number of the parameter*/
 	switch (num_of_param) {
 	/*if its the first parameter encode normaly*/
 	case 1:
-		/*encode the value of the register */
-		word = word | encode_src_reg(get_reg_val(token));
-		word = word | ABS;
-
-		/*update the reserved code word with the endoed value*/
-		mem_img->code->code_entries[mem_img->code->ic].bin_machine_code = word;
-		mem_img->code->ic++;
+		/*encode the value of the register and add it to the code table*/
+		err_val = add_code(code, encode_src_reg(reg) | ABS);
 		break;
 	case 2:
-		/*if its the second parameter check if the first was a register */
+		/* if its the second parameter check if the first was a register
+		 * if it was then both share the previous word in the code table*/
 		if (reg_flag)
-			/*if it was then encode the previous word in the code table*/
-			mem_img->code->ic--;
-
+			code->words[code->ic - 1] |= encode_dest_reg(reg);
 		/*if not the encode normaly*/
-		mem_img->code->code_entries[mem_img->code->ic].bin_machine_code =
-				mem_img->code->code_entries[mem_img->code->ic].bin_machine_code |
-				encode_dest_reg(get_reg_val(token));
-
-		mem_img->code->ic++;
+		else
+			err_val = add_code(code, encode_dest_reg(reg));
 		break;
 	}
+
+	return err_val;
+}
+
+/* get_param_value : a function to get the value of a number or a macro parameter
+ * parameters      : token      - the number or the name of the macro
+ * 					 len        - the length of the token
+ * 					 symtable_p - a pointer to a symbol table
+ * return          : the value of the parameter*/
+static int get_param_value(const char *token, const int len, symtable *symtable_p) {
+	return char_is(token[0], CHAR_ALPHA) ? find_symbol_n(token, len, symtable_p)->value :
+		   atoi(token);
+}
+
+/* encode_word : write the special 4 base digits of a word, only the bits of the word
+ * 				 size are encoded so negative values wrap like the machine does
+ * parameters  : word - the word to encode
+ * 				 out  - the output for the digits, they are not terminated
+ * return      : a pointer to the character after the digits*/
+static char *encode_word(const int word, char *out) {
+	const char *high = digits_table[((unsigned int)word >> BITS_PER_ENTRY) & HIGH_ENTRY_MASK],
+			   *low = digits_table[(unsigned int)word & LOW_ENTRY_MASK];
+
+	/*the high entry always starts with a 0 digit the word doesnt have*/
+	memcpy(out, high + DIGITS_PER_ENTRY - HIGH_DIGITS, HIGH_DIGITS);
+	memcpy(out + HIGH_DIGITS, low, DIGITS_PER_ENTRY);
+
+	return out + SPECIAL_BASE_WORD_SIZE;
+}
+
+/* encode_address : write an address like format_number does with ADDRESS_DIGITS
+ * 					zeros, it is kept here so the loop over the words can inline it
+ * parameters     : address - the address to write, it is not negative
+ * 					out     - the output for the digits, they are not terminated
+ * return         : a pointer to the character after the digits*/
+static char *encode_address(int address, char *out) {
+	char *end = out + ADDRESS_DIGITS,
+		 *pos;
+	int  rest;
+
+	for (rest = address / FIRST_LONG_ADDRESS; rest; rest /= 10)
+		end++;
+
+	/*the digits above the address are zeros from the table*/
+	for (pos = end; pos - out > 1; address /= 100) {
+		pos -= 2;
+		memcpy(pos, decimal_pairs + 2 * (address % 100), 2);
+	}
+	if (pos > out)
+		*--pos = '0' + address;
+
+	return end;
+}
+
+/* encode_line : write a line of the object file, the address and the word
+ * parameters  : address - the address of the word
+ * 				 word    - the word to write
+ * 				 out     - the output for the line, it is not terminated
+ * return      : a pointer to the character after the line*/
+static char *encode_line(const int address, const int word, char *out) {
+	out = encode_address(address, out);
+	*out++ = ' ';
+	out = encode_word(word, out);
+	*out++ = '\n';
+
+	return out;
 }
 
 /* word_to_4_special_base : a function to translate from binary to the special 4
  * 				            base of the assembler
- * parameters             : */
+ * parameters             : word         - the word to translate
+ * 							special_base - the output for the terminated digits
+ * return                 :*/
 void word_to_4_special_base(int word, char *special_base) {
-	int mask = BASE_MASK,
-		i;
+	*encode_word(word, special_base) = '\0';
+}
 
+/* object_lines_size : compute the size of the lines of the first words of the object
+ * 					   file, a line is as long as its address and the addresses of
+ * 					   the words follow one another from ADDRESS_OFFSET
+ * parameters        : num_of_words - the number of words, code first then data
+ * return            : the number of characters encode_object_words writes for them*/
+long object_lines_size(const int num_of_words) {
+	long size = 0,
+		 address = ADDRESS_OFFSET,
+		 end = ADDRESS_OFFSET + (long)num_of_words,
+		 limit = (long)FIRST_LONG_ADDRESS;
+	int  digits = ADDRESS_DIGITS;
+
+	/*count the words of every number of digits, ADDRESS_OFFSET is below the limit*/
+	for (; address < end; address = limit, limit *= 10, digits++)
+		size += ((end < limit ? end : limit) - address) *
+				(digits + SPECIAL_BASE_WORD_SIZE + 2);
+
+	return size;
+}
 
-	special_base[SPECIAL_BASE_WORD_SIZE] = '\0';
+/* encode_object_words : write a range of the words of a memory image as lines of the
+ * 						 object file, the words are numbered with the code first and
+ * 						 the data after it and each line takes at most
+ * 						 MAX_OBJECT_LINE_LEN characters
+ * parameters          : mem_img - a pointer to a memory image
+ * 						 first   - the number of the first word to write
+ * 						 count   - the number of words to write
+ * 						 out     - the output for the lines, they are not terminated
+ * return              : a pointer to the character after the lines*/
+char *encode_object_words(const memory_image *mem_img, const int first, const int count,
+						  char *out) {
+	const machine_word *code = mem_img->code->words,
+					   *data = mem_img->data->words;
+	int 			   i = first,
+					   end = first + count,
+					   code_end = end < mem_img->code->ic ? end : mem_img->code->ic;
+
+	/*the number of a word is its address less ADDRESS_OFFSET*/
+	for (; i < code_end; i++)
+		out = encode_line(i + ADDRESS_OFFSET, code[i], out);
+	for (; i < end; i++)
+		out = encode_line(i + ADDRESS_OFFSET, data[i - mem_img->code->ic], out);
+
+	return out;
+}
 
-	/*the index of the special character in the special 4 table is its value
-	 * so we get the value of the encoded binary word and translate every 2 digits
-	 * to its representative special character in base 4*/
-	for (i = SPECIAL_BASE_WORD_SIZE - 1; i >= 0; i--) {
-		special_base[i] = special_base_table[word & mask];
+/* classify_operand : a function to get the addressing mode of a parameter, the
+ * 					  parameter is looked up in the keywords once
+ * parameters       : param - the parameter to get its addressing mode
+ * 					  kw    - the output for the keyword the parameter is or NULL
+ * return           : the parameters addresing mode*/
+static int classify_operand(const char *param, const keyword **kw) {
+	addressing_mode mode;
 
-		/*we shift the word to encoded all the word*/
-		word >>= BASE_MOVE;
+	*kw = NULL;
+	if (param[0] == '#')
+		mode = IMMEDIATE;
+	else if ((*kw = find_keyword(param)) && (*kw)->kind == REGISTER_KEYWORD)
+		mode = REGISTER;
+	else if (!*kw && !valid_label_syntax(param, strlen(param)))
+		mode = DIRECT;
+	else
+		mode = INDEX;
+
+	return mode;
+}
+
+/* decode_operand : a function to decode a parameter of an instruction line once so
+ * 					it doesnt need to be parsed again to be encoded
+ * parameters     : param      - the parameter to decode
+ * 					symtable_p - a pointer to a symbol table
+ * 					ir_p       - a pointer to the ir table that keeps the names
+ * 					operand    - a pointer to the operand to fill
+ * return         : NO_ERROR           - if no error occured
+ * 					ERROR_MEMORY_ALLOC - if there was an error copying a name*/
+error_value decode_operand(const char *param, symtable *symtable_p, ir_table *ir_p,
+						   decoded_operand *operand) {
+	error_value   err_val = NO_ERROR;
+	const char    *index,
+				  *end;
+	const keyword *kw;
+	int 		  mode = classify_operand(param, &kw);
+
+	operand->mode = mode;
+	operand->value = 0;
+	operand->word = -1;
+	operand->pending = FALSE;
+	operand->symbol = operand->extern_name = NULL;
+
+	switch (mode) {
+	/*the value of a number or a macro*/
+	case IMMEDIATE:
+		operand->value = get_param_value(param + 1, strlen(param + 1), symtable_p);
+		break;
+		/*the symbol is written as is to the externals file*/
+	case DIRECT:
+		if (!(operand->symbol = operand->extern_name = arena_strdup(ir_p->arena, ARENA_IR,
+																	 param)))
+			err_val = ERROR_MEMORY_ALLOC;
+		break;
+		/*the symbol is the name of the array and the value is its index
+		 * the whole parameter is written to the externals file*/
+	case INDEX:
+		index = strchr(param, '[') + 1;
+		end = strchr(index, ']');
+		if (!(operand->symbol = arena_strndup(ir_p->arena, ARENA_IR, param,
+											  index - param - 1)) ||
+			!(operand->extern_name = arena_strdup(ir_p->arena, ARENA_IR, param)))
+			err_val = ERROR_MEMORY_ALLOC;
+		operand->value = get_param_value(index, end - index, symtable_p);
+		break;
+		/*the number of the register*/
+	case REGISTER:
+		operand->value = kw->reg;
+		break;
+	default:
+		err_val = SYNTAX_ERROR;
 	}
+
+	return err_val;
 }
 
-/* encode_instruction : a function to finish encoding the instruciton line
- * 						after we encoded the first word in the first pass
- * parameters         : token      - the parameters of the line
+/* encode_instruction : a function to encode a decoded instruction to the code table
+ * parameters         : inst       - a pointer to the decoded instruction
  * 						symtable_p - a pointer to a symbol table
  * 				        mem_img    - a pointer to a memory image
- * return             : NO_ERROR    - if no error occured
- * 						LABEL_UNDEF - if a parameter is an undefined label */
-error_value encode_instruction(char *token, symtable *symtable_p,
+ * return             : NO_ERROR           - if no error occured
+ * 						ERROR_MEMORY_ALLOC - if there was an error allocating the words
+ * 						SYNTAX_ERROR       - if a parameter has no addressing mode*/
+error_value encode_instruction(decoded_instruction *inst, symtable *symtable_p,
 							   memory_image *mem_img) {
-	error_value     err_val = NO_ERROR;
+	error_value     err_val;
+	code_table      *code = mem_img->code;
+	decoded_operand *operand = inst->operands;
 	int   			i,
-					reg_flag = FALSE,
-					op_params = get_op_num_of_params(token);
-	addressing_mode addr_mode;
-
-	/*itterate every parameter of the line*/
-	for (i = 0, mem_img->code->ic++; !err_val && i < op_params; i++) {
-		token = strtok(NULL, PARSING_PARAMS_TOKENS);
-		/*get the addressinf mode of the parameter*/
-		addr_mode = get_addr_mode(token, symtable_p);
-
-		switch (addr_mode) {
+					word = encode_op(inst->op),
+					reg_flag = FALSE;
+
+	/*the addressing mode of a single parameter is encoded as a destination*/
+	if (inst->num_of_operands == 1)
+		word = word | encode_dest_mode(get_addr_mode_val(operand[0].mode));
+	else if (inst->num_of_operands == 2)
+		word = word | encode_src_mode(get_addr_mode_val(operand[0].mode)) |
+			   encode_dest_mode(get_addr_mode_val(operand[1].mode));
+
+	/*add the first word and then a word for every parameter of the line*/
+	inst->word = code->ic;
+	err_val = add_code(code, word);
+	for (i = 0; !err_val && i < inst->num_of_operands; i++, operand++) {
+		switch (operand->mode) {
 		/*if the parameters addressing mode is IMMEDIATE*/
 		case IMMEDIATE:
-			encode_immediate(mem_img, symtable_p, token);
+			err_val = add_code(code, encode_dest_mode(operand->value) | ABS);
 			break;
 			/*if the parameters addressing mode is DIRECT*/
 		case DIRECT:
-			err_val = encode_direct(mem_img, symtable_p, token);
+			err_val = encode_symbol(operand, symtable_p, code);
 			break;
-			/*if the parameters addressing mode is INDEX*/
+			/*if the parameters addressing mode is INDEX the index follows the array*/
 		case INDEX:
-			err_val = encode_index(mem_img, symtable_p, token);
+			if (!(err_val = encode_symbol(operand, symtable_p, code)))
+				err_val = add_code(code, encode_dest_mode(operand->value) | ABS);
 			break;
 			/*if the parameters addressing mode is REGISTER*/
 		case REGISTER:
-			encode_register(mem_img, token, reg_flag, i + 1);
+			err_val = encode_register(code, operand->value, reg_flag, i + 1);
 			reg_flag = TRUE;
 			break;
 		default:
@@ -266,23 +412,46 @@ error_value encode_instruction(char *token, symtable *symtable_p,
 	return err_val;
 }
 
+/* encode_pending : a function to complete the words of an instruction that refer to
+ * 				    symbols after the first pass, once all the symbols have their
+ * 				    final values
+ * parameters     : inst       - a pointer to the decoded instruction
+ * 				    symtable_p - a pointer to a symbol table
+ * 				    mem_img    - a pointer to a memory image
+ * return         : NO_ERROR           - if no error occured
+ * 				    LABEL_UNDEF        - if a symbol is undefined
+ * 				    ERROR_MEMORY_ALLOC - if there was an error listing an external word*/
+error_value encode_pending(decoded_instruction *inst, symtable *symtable_p,
+						   memory_image *mem_img) {
+	error_value     err_val = NO_ERROR;
+	decoded_operand *operand;
+	symtable_entry  *sym;
+	int 			i;
+
+	/*like with the lines of the source stop at the first error*/
+	for (i = 0, operand = inst->operands; !err_val && i < inst->num_of_operands;
+		 i++, operand++)
+		if (operand->pending) {
+			/*check if the label is defined and if it is encode the word*/
+			if ((sym = find_symbol(operand->symbol, symtable_p))) {
+				err_val = encode_symbol_word(mem_img->code, operand->word, sym,
+											 operand->extern_name);
+				operand->pending = FALSE;
+			} else
+				err_val = LABEL_UNDEF;
+		}
+
+	return err_val;
+}
+
 /* get_addr_mode : a function to get the addressing mode of a parameter
  * parameters    : param      - the parameter to get its addressing mode
  * 				   symtable_p - a pointer to a symbol table
  * return        : the parameters addresing mode*/
 int get_addr_mode(char *param, symtable *symtable_p) {
-	addressing_mode mode;
-
-	if (param[0] == '#')
-		mode = IMMEDIATE;
-	else if (!valid_label(param, symtable_p))
-		mode = DIRECT;
-	else if (get_reg_val(param) >= 0)
-		mode = REGISTER;
-	else
-		mode = INDEX;
+	const keyword *kw;
 
-	return mode;
+	return classify_operand(param, &kw);
 }
 
 /* get_addt_mode_val : a function to get the value of an addressing mode
@@ -5,6 +5,7 @@
 #include "error.h"
 #include "symtable.h"
 #include "memory_image.h"
+#include "ir.h"
 
 /*enum of the locations of every part of the encoded word*/
 typedef enum{
@@ -17,6 +18,15 @@ typedef enum{
 	DEST_REG = 2
 }word_loc;
 
+/*the number of special base digits of an encoded word*/
+#define SPECIAL_BASE_WORD_SIZE (WORD_SIZE / 2)
+/*the least number of digits of an address in the output files*/
+#define ADDRESS_DIGITS 4
+/*the most decimal digits of an address*/
+#define MAX_ADDRESS_DIGITS 10
+/*the longest line of the object file, an address, a space, a word and a newline*/
+#define MAX_OBJECT_LINE_LEN (MAX_ADDRESS_DIGITS + SPECIAL_BASE_WORD_SIZE + 2)
+
 /*macros for encoding words*/
 #define encode_op(op) ((int)(op << OP_CODE))
 #define encode_src_mode(src_mode) ((int)(src_mode << SRC_ADDRESSING_MODE))
@@ -24,8 +34,12 @@ typedef enum{
 #define encode_src_reg(reg) ((int)(reg << SRC_REG))
 #define encode_dest_reg(reg) ((int)(reg << DEST_REG))
 
-error_value encode_instruction(char*, symtable*, memory_image*);
+error_value decode_operand(const char*, symtable*, ir_table*, decoded_operand*);
+error_value encode_instruction(decoded_instruction*, symtable*, memory_image*);
+error_value encode_pending(decoded_instruction*, symtable*, memory_image*);
 void word_to_4_special_base(int, char*);
+long object_lines_size(const int);
+char *encode_object_words(const memory_image*, const int, const int, char*);
 int get_addr_mode(char*, symtable*);
 int get_addr_mode_val(int);
 
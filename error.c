@@ -1,109 +1,213 @@
 #include "error.h"
 
-void print_error(error_value err_val, const char *file_name, const int index) {
+/*the size of the text of a message after the name of the file, a name of any length
+ * is written on its own so it isnt counted*/
+#define MAX_MESSAGE_LEN 128
+/*what separates the name of the file from the text of a message*/
+#define NAME_SEPARATOR ": "
+/*the size a diagnostics buffer starts with*/
+#define DIAGNOSTICS_INIT_CAPACITY 256
+
+/* format_error : format the text of the message of an error that follows the name
+ * 				  of the file
+ * parameters   : text    - the output for the text
+ * 				  err_val - the error to format
+ * 				  index   - the number of the line the error occured in
+ * return       : TRUE if the message starts with the name of the file else FALSE*/
+static int format_error(char *text, error_value err_val, const int index) {
 	switch (err_val) {
 	case NO_PARAMETERS:
-		printf("no parameters provided\n");
-		break;
+		sprintf(text, "no parameters provided\n");
+		return FALSE;
 	case INVALID_FILE_NAME:
-		printf("%s: file doesn't exist\n", file_name);
+		sprintf(text, "file doesn't exist\n");
 		break;
 	case ERROR_MEMORY_ALLOC:
-		printf("%s: unable to allocate memory\n", file_name);
+		sprintf(text, "unable to allocate memory\n");
 		break;
 	case LINE_TOO_LONG:
-		printf("%s: %d: line too long\n", file_name, index);
+		sprintf(text, "%d: line too long\n", index);
 		break;
 	case LABEL_TOO_LONG:
-		printf("%s: %d: the label is too long\n", file_name, index);
+		sprintf(text, "%d: the label is too long\n", index);
 		break;
 	case INVALID_LABEL:
-		printf("%s: %d: the label is illegal\n", file_name, index);
+		sprintf(text, "%d: the label is illegal\n", index);
 		break;
 	case DUPLICATE_LABEL:
-		printf("%s: %d: label already exists\n", file_name, index);
+		sprintf(text, "%d: label already exists\n", index);
 		break;
 	case INVALID_DIRECTIVE:
-		printf("%s: %d: invalid directive\n", file_name, index);
+		sprintf(text, "%d: invalid directive\n", index);
 		break;
 	case INVALID_INSTRUCTION:
-		printf("%s: %d: invalid instruction\n", file_name, index);
+		sprintf(text, "%d: invalid instruction\n", index);
 		break;
 	case RESERVED_WORD:
-		printf("%s: %d: symbol is a reserved word\n", file_name, index);
+		sprintf(text, "%d: symbol is a reserved word\n", index);
 		break;
 	case SYNTAX_ERROR:
-		printf("%s: %d: syntax error\n", file_name, index);
+		sprintf(text, "%d: syntax error\n", index);
 		break;
 	case INVALID_MACRO:
-		printf("%s: %d: the macro is illegal\n", file_name, index);
+		sprintf(text, "%d: the macro is illegal\n", index);
 		break;
 	case NOT_A_NUMBER:
-		printf("%s: %d: parameter is not a legal number\n", file_name, index);
+		sprintf(text, "%d: parameter is not a legal number\n", index);
 		break;
 	case MACRO_TOO_LONG:
-		printf("%s: %d: the macro name is too long\n", file_name, index);
+		sprintf(text, "%d: the macro name is too long\n", index);
 		break;
 	case MACRO_AFTER_LABEL:
-		printf("%s: %d: macro and lable in the same line is not allowed\n",
-			   file_name, index);
+		sprintf(text, "%d: macro and lable in the same line is not allowed\n",
+				index);
 		break;
 	case INVALID_PARAMETERS:
-		printf("%s: %d: invalid parameters to operation\n", file_name, index);
+		sprintf(text, "%d: invalid parameters to operation\n", index);
 		break;
 	case DUPLICATE_MACRO:
-		printf("%s: %d: macro name already defined\n", file_name, index);
+		sprintf(text, "%d: macro name already defined\n", index);
 		break;
 	case INVALID_STRING:
-		printf("%s: %d: the string is invalid\n", file_name, index);
+		sprintf(text, "%d: the string is invalid\n", index);
 		break;
 	case INVALID_NUM_OF_PARAMS:
-		printf("%s: %d: invalid number of parameters for operation\n",
-			   file_name, index);
+		sprintf(text, "%d: invalid number of parameters for operation\n",
+				index);
 		break;
 	case MACRO_PARAM_UNDEFINED:
-		printf("%s: %d: the macro data parameter in not defined yet\n",
-	           file_name, index);
+		sprintf(text, "%d: the macro data parameter in not defined yet\n",
+				index);
 		break;
 	case INVALID_PARAMETER:
-		printf("%s: %d: invalid parameter to operation\n", file_name, index);
+		sprintf(text, "%d: invalid parameter to operation\n", index);
 		break;
 	case INVALID_ADDR_SRC_MODE:
-		printf("%s: %d: the operation doesn't support this addressing source mode\n",
-			   file_name, index);
+		sprintf(text,
+				"%d: the operation doesn't support this addressing source mode\n",
+				index);
 		break;
 	case INVALID_ADDR_DEST_MODE:
-		printf("%s: %d: the operation doesn't support this addressing destination mode\n",
-			   file_name, index);
+		sprintf(text,
+				"%d: the operation doesn't support this addressing destination mode\n",
+				index);
 		break;
 	case ERROR_OPEN_FILE:
-		printf("%s: unable to open file\n", file_name);
+		sprintf(text, "unable to open file\n");
 		break;
 	case ERROR_PASS1:
-		printf("%s: first pass failed\n", file_name);
+		sprintf(text, "first pass failed\n");
 		break;
 	case ERROR_PASS2:
-		printf("%s: second pass failed\n", file_name);
+		sprintf(text, "second pass failed\n");
 		break;
 	case ENTRY_UNDEFINED:
-		printf("%s: %d: the entry point is undefined\n", file_name, index);
+		sprintf(text, "%d: the entry point is undefined\n", index);
 		break;
 	case LABEL_UNDEF:
-		printf("%s: %d: the label parameter is undefined\n", file_name, index);
+		sprintf(text, "%d: the label parameter is undefined\n", index);
 		break;
 	case ERROR_CREATE_FILE:
-		printf("%s: failed to create a file\n", file_name);
+		sprintf(text, "failed to create a file\n");
 		break;
 	case NO_ERROR:
-		printf("%s: processed no error\n", file_name);
+		sprintf(text, "processed no error\n");
 		break;
 	case NO_MACRO_PARAM:
-		printf("%s: %d: macro parameter is no provided\n", file_name, index);
+		sprintf(text, "%d: macro parameter is no provided\n", index);
 		break;
 	case EMPTY_LABEL:
-		printf("%s: %d: empty label declared\n", file_name, index);
+		sprintf(text, "%d: empty label declared\n", index);
+		break;
+	case INVALID_NUM_OF_JOBS:
+		sprintf(text, "invalid number of jobs\n");
+		return FALSE;
+	case INVALID_OPTION:
+		sprintf(text, "invalid option\n");
+		break;
+	case ERROR_CONNECT:
+		sprintf(text, "unable to reach the assembler server\n");
+		break;
+	case ERROR_LISTEN:
+		sprintf(text, "unable to listen, the socket is invalid or in use\n");
 		break;
 	default:
-		printf("%s: encountered an unexpected error", file_name);
+		sprintf(text, "encountered an unexpected error");
+	}
+
+	return TRUE;
+}
+
+/* print_error : print the message of an error
+ * parameters  : err_val   - the error to print
+ * 				 file_name - the name of the file the error occured in
+ * 				 index     - the number of the line the error occured in
+ * return      :*/
+void print_error(error_value err_val, const char *file_name, const int index) {
+	char text[MAX_MESSAGE_LEN];
+
+	if (format_error(text, err_val, index))
+		printf("%s" NAME_SEPARATOR, file_name);
+	fputs(text, stdout);
+}
+
+/* diagnostics_init : initialize an empty diagnostics buffer
+ * parameters       : diag - a pointer to a diagnostics buffer
+ * return           :*/
+void diagnostics_init(diagnostics *diag) {
+	diag->text = NULL;
+	diag->size = 0;
+	diag->capacity = 0;
+}
+
+/* report_error : keep the message of an error in a diagnostics buffer to print it
+ * 				  later, if there is no buffer or it cant grow the message is printed
+ * parameters   : diag      - a pointer to a diagnostics buffer or NULL
+ * 				  err_val   - the error to report
+ * 				  file_name - the name of the file the error occured in
+ * 				  index     - the number of the line the error occured in
+ * return       :*/
+void report_error(diagnostics *diag, error_value err_val, const char *file_name,
+				  const int index) {
+	char   text[MAX_MESSAGE_LEN],
+		   *grown;
+	size_t name_len = 0,
+		   len,
+		   capacity;
+
+	if (format_error(text, err_val, index))
+		name_len = strlen(file_name) + strlen(NAME_SEPARATOR);
+	len = name_len + strlen(text);
+
+	/*if the buffer is full double its size*/
+	if (diag && diag->size + len > diag->capacity) {
+		capacity = diag->capacity ? diag->capacity : DIAGNOSTICS_INIT_CAPACITY;
+		while (diag->size + len > capacity)
+			capacity *= 2;
+		if ((grown = realloc(diag->text, capacity))) {
+			diag->text = grown;
+			diag->capacity = capacity;
+		}
+	}
+
+	if (diag && diag->size + len <= diag->capacity) {
+		if (name_len)
+			sprintf(diag->text + diag->size, "%s" NAME_SEPARATOR, file_name);
+		memcpy(diag->text + diag->size + name_len, text, len - name_len);
+		diag->size += len;
+	} else {
+		if (name_len)
+			printf("%s" NAME_SEPARATOR, file_name);
+		fputs(text, stdout);
 	}
 }
+
+/* diagnostics_flush : print all the messages in a diagnostics buffer and release it
+ * parameters        : diag - a pointer to a diagnostics buffer
+ * return            :*/
+void diagnostics_flush(diagnostics *diag) {
+	if (diag->size)
+		fwrite(diag->text, 1, diag->size, stdout);
+	free(diag->text);
+	diagnostics_init(diag);
+}
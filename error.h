@@ -4,6 +4,7 @@
 #include "error.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include "defs.h"
 
 typedef enum {
 	IS_MACRO = 4,
@@ -43,9 +44,25 @@ typedef enum {
 	LABEL_UNDEF = -30,
 	ERROR_CREATE_FILE = -31,
 	NO_MACRO_PARAM = -32,
-	EMPTY_LABEL = -33
+	EMPTY_LABEL = -33,
+	INVALID_NUM_OF_JOBS = -34,
+	INVALID_OPTION = -35,
+	ERROR_CONNECT = -36,
+	ERROR_LISTEN = -37
 } error_value;
 
+/* a buffer of the messages of the errors of one file
+ * the files may be assembled at the same time so their messages are kept and
+ * printed in the order of the files*/
+typedef struct{
+	char *text;
+	size_t size;
+	size_t capacity;
+} diagnostics;
+
 void print_error(error_value, const char*, const int);
+void diagnostics_init(diagnostics*);
+void report_error(diagnostics*, error_value, const char*, const int);
+void diagnostics_flush(diagnostics*);
 
 #endif
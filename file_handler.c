@@ -1,109 +1,367 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <unistd.h>
+#include <pthread.h>
 #include "file_handler.h"
 #include "error.h"
 #include "encoder.h"
+#include "output.h"
+
+/*the number of words encoded into the buffer of the object file at a time*/
+#define OBJECT_CHUNK_WORDS 1024
+/*the width of the number of code words in the header of the object file*/
+#define OBJECT_HEADER_WIDTH 4
+/*the least number of words an object file has to be mapped, and of every thread*/
+#define MIN_WORDS_PER_THREAD 65536
+/*the most threads that fill a mapped object file*/
+#define MAX_OBJECT_THREADS 8
+
+/*the extensions of the output files*/
+const char *output_exts[NUM_OF_OUTPUTS] = {
+	OBJECT_FILE_EXT, EXTERNALS_FILE_EXT, ENTRIES_FILE_EXT
+};
+
+/*a struct representing a range of the words of a mapped object file to fill*/
+typedef struct{
+	const memory_image *mem_img;
+	int first;
+	int count;
+	char *out;
+} object_range;
+
+/* open_output : open an output file or start capturing it in memory
+ * parameters  : out            - a pointer to the output file to open
+ * 				 file_name      - the name of the file
+ * 				 keep_unchanged - TRUE to keep the file if it is the same as before
+ * 				 captured       - the output for a captured file or NULL
+ * return      : NO_ERROR           - if the output is ready to be written
+ * 				 ERROR_CREATE_FILE  - if the file couldnt be created
+ * 				 ERROR_MEMORY_ALLOC - if there was an error allocating the buffer*/
+static error_value open_output(output_file *out, const char *file_name,
+							   const int keep_unchanged, output_bytes *captured) {
+	if (captured)
+		return output_capture(out, captured, 0);
+
+	return output_open(out, file_name, keep_unchanged);
+}
+
+/* output_symbol_line : add a line of a symbol and an address to an output file
+ * parameters         : out     - a pointer to the output file
+ * 						name    - the name of the symbol
+ * 						len     - the length of the name
+ * 						address - the address to write after it
+ * return             :*/
+static void output_symbol_line(output_file *out, const char *name, const size_t len,
+							   const int address) {
+	char *end;
+
+	output_text(out, name, len);
+	end = output_reserve(out, MAX_ADDRESS_DIGITS + 2);
+	*end++ = '\t';
+	end = format_number(address, ADDRESS_DIGITS, '0', end);
+	*end++ = '\n';
+	output_commit(out, end);
+}
+
+/* compare_extern_refs : compare two references to external symbols by their addresses
+ * parameters          : a - a pointer to the first reference
+ * 						 b - a pointer to the second reference
+ * return              : a negative value if the first address is lower else a
+ * 						 positive value*/
+static int compare_extern_refs(const void *a, const void *b) {
+	return ((const extern_ref*)a)->address < ((const extern_ref*)b)->address ? -1 : 1;
+}
 
-/* create_extern_file : create the externals file
- * parameters         : file_base    - the base file name
- * 						code_table_p - a pointer to a code table
- * return             : NO_ERROR          - if created the file succesfully
- * 						ERROR_CREATE_FILE - if an error occured creating the file*/
-static error_value create_extern_file(const char *file_base, code_table *code_table_p) {
-	error_value     err_val = NO_ERROR;
-	char 		    file_name[MAX_FILE_NAME_LEN];
+/* create_extern_file : create the externals file from the list of the words that
+ * 						refer to external symbols, in the order of their addresses
+ * parameters         : file_base      - the base file name
+ * 						code_table_p   - a pointer to a code table
+ * 						keep_unchanged - TRUE to keep a file that is the same as before
+ * 						captured       - the output for a captured file or NULL
+ * 						written        - a pointer to the count of characters written
+ * return             : NO_ERROR           - if created the file succesfully
+ * 						ERROR_CREATE_FILE  - if an error occured creating the file
+ * 						ERROR_MEMORY_ALLOC - if there was an error allocating the buffer*/
+static error_value create_extern_file(const char *file_base, code_table *code_table_p,
+									  const int keep_unchanged, output_bytes *captured,
+									  long *written) {
+	error_value     err_val;
+	char 		    *file_name;
 	int			    i;
-	FILE	        *fp;
+	size_t 			len;
+	output_file     out;
+	extern_ref      *ref;
 
 	/*create the file name with .ext extension*/
-	make_file_name(file_base, EXTERNALS_FILE_EXT, file_name);
+	if (!(file_name = new_file_name(file_base, EXTERNALS_FILE_EXT)))
+		return ERROR_MEMORY_ALLOC;
 
 	/*try to create the file*/
-	if ((fp = fopen(file_name, WRITE_APPEND))) {
+	if (!(err_val = open_output(&out, file_name, keep_unchanged, captured))) {
 
-		/*if succesfully created the file itterate over the code table
-		 * and add every value flagged as external to the file*/
-		for (i = 0; i < code_table_p->ic; i++)
-			if (code_table_p->code_entries[i].bin_machine_code == 1)
-				fprintf(fp, "%s\t%04d\n",
-						code_table_p->code_entries[i].extern_name,
-						code_table_p->code_entries[i].address);
+		/* the words that were completed after the first pass were listed after the
+		 * ones that follow them so sort the list, a name is cut to the length
+		 * of the longest label*/
+		qsort(code_table_p->extern_refs, code_table_p->num_of_extern_refs,
+			  sizeof(extern_ref), compare_extern_refs);
+		for (i = 0, ref = code_table_p->extern_refs;
+			 i < code_table_p->num_of_extern_refs; i++, ref++) {
+			if ((len = strlen(ref->name)) > MAX_LABEL_LEN - 1)
+				len = MAX_LABEL_LEN - 1;
+			output_symbol_line(&out, ref->name, len, ref->address);
+		}
 
-		fclose(fp);
-	} else /*if unable to create the file*/
-		err_val = ERROR_CREATE_FILE;
+		err_val = output_close(&out);
+		*written += out.written;
+	}
+	free(file_name);
 
 	return err_val;
 
 }
 
 /* create_entry_file : create the entries file
- * parameters        : file_base  - the base file name
- * 					   symtable_p - a pointer to a symbol table
- * return            : NO_ERROR          - if created the file succesfully
- * 				       ERROR_CREATE_FILE - if an error occured creating the file*/
-static error_value create_entry_file(const char *file_base, symtable *symtable_p) {
-	error_value err_val = NO_ERROR;
-	char	    file_name[MAX_FILE_NAME_LEN];
+ * parameters        : file_base      - the base file name
+ * 					   symtable_p     - a pointer to a symbol table
+ * 					   keep_unchanged - TRUE to keep a file that is the same as before
+ * 					   captured       - the output for a captured file or NULL
+ * 					   written        - a pointer to the count of characters written
+ * return            : NO_ERROR           - if created the file succesfully
+ * 				       ERROR_CREATE_FILE  - if an error occured creating the file
+ * 				       ERROR_MEMORY_ALLOC - if there was an error allocating the buffer*/
+static error_value create_entry_file(const char *file_base, symtable *symtable_p,
+									 const int keep_unchanged, output_bytes *captured,
+									 long *written) {
+	error_value err_val;
+	char	    *file_name;
 	int 		i;
-	FILE	    *fp;
+	output_file out;
 
 	/*create the file name with .ent extension*/
-	make_file_name(file_base, ENTRIES_FILE_EXT, file_name);
+	if (!(file_name = new_file_name(file_base, ENTRIES_FILE_EXT)))
+		return ERROR_MEMORY_ALLOC;
 
 	/*try to create the file*/
-	if ((fp = fopen(file_name, WRITE_APPEND))) {
+	if (!(err_val = open_output(&out, file_name, keep_unchanged, captured))) {
 
 		/* if succesfully created the file itterate over the symbol table
 		 * and add every value flagged as entry to the file*/
 		for (i = 0; i < symtable_p->table_size; i++)
 			if (symtable_p->symtable_entries[i].type == ENTRY)
-				fprintf(fp, "%s\t%04d\n", symtable_p->symtable_entries[i].name,
-										 symtable_p->symtable_entries[i].value);
-		fclose(fp);
-	} else /*if unable to create the file*/
-		err_val = ERROR_CREATE_FILE;
+				output_symbol_line(&out, symtable_p->symtable_entries[i].name,
+								   strlen(symtable_p->symtable_entries[i].name),
+								   symtable_p->symtable_entries[i].value);
+
+		err_val = output_close(&out);
+		*written += out.written;
+	}
+	free(file_name);
 
 	return err_val;
 }
 
-/* create_object_file : create the object file
- * parameters         : file_base  - the base file name
- * 					    mem_img    - a pointer to a memory image
- * return             : NO_ERROR          - if created the file succesfully
- * 				        ERROR_CREATE_FILE - if an error occured creating the file*/
-static error_value create_object_file(const char *file_base, memory_image *mem_img) {
-	error_value err_val = NO_ERROR;
-	char 	    base_4_word[WORD_SIZE / 2 + 1];
-	char 		file_name[MAX_FILE_NAME_LEN];
-	FILE 		*fp;
-	int 		i;
+/* fill_object_range : the function of a thread that fills a range of the words of a
+ * 					   mapped object file
+ * parameters        : arg - a pointer to the range
+ * return            : NULL*/
+static void *fill_object_range(void *arg) {
+	object_range *range = arg;
+
+	encode_object_words(range->mem_img, range->first, range->count, range->out);
+
+	return NULL;
+}
+
+/* object_threads : choose the number of threads that fill a mapped object file
+ * parameters     : num_of_words - the number of words of the file
+ * return         : the number of threads, at least 1*/
+static int object_threads(const int num_of_words) {
+	long num_of_threads = num_of_words / MIN_WORDS_PER_THREAD,
+		 cpus = MAX_OBJECT_THREADS;
+
+#ifdef _SC_NPROCESSORS_ONLN
+	/*there is no use for more threads than processors*/
+	if ((cpus = sysconf(_SC_NPROCESSORS_ONLN)) < 1)
+		cpus = 1;
+#endif
+
+	if (num_of_threads > cpus)
+		num_of_threads = cpus;
+	if (num_of_threads > MAX_OBJECT_THREADS)
+		num_of_threads = MAX_OBJECT_THREADS;
+
+	return num_of_threads > 1 ? (int)num_of_threads : 1;
+}
+
+/* create_mapped_object_file : create the object file at its exact size and map it,
+ * 							   the offset of every line is known from the number of
+ * 							   words before it so disjoint ranges of the words are
+ * 							   encoded in place by several threads
+ * parameters                : file_name      - the name of the object file
+ * 							   mem_img        - a pointer to a memory image
+ * 							   header         - the header line of the file
+ * 							   header_len     - the length of the header line
+ * 							   keep_unchanged - TRUE to keep a file that is the same as before
+ * 							   captured       - the output for a captured file or NULL
+ * 							   written        - a pointer to the count of characters written
+ * return                    : NO_ERROR          - if created the file succesfully
+ * 							   ERROR_CREATE_FILE - if the file couldnt be created or mapped*/
+static error_value create_mapped_object_file(const char *file_name, memory_image *mem_img,
+											 const char *header, const int header_len,
+											 const int keep_unchanged,
+											 output_bytes *captured, long *written) {
+	error_value  err_val;
+	output_file  out;
+	object_range ranges[MAX_OBJECT_THREADS];
+	pthread_t 	 threads[MAX_OBJECT_THREADS];
+	size_t 		 size;
+	int 		 started[MAX_OBJECT_THREADS],
+				 num_of_words = mem_img->code->ic + mem_img->data->dc,
+				 num_of_threads = object_threads(num_of_words),
+				 i;
+
+	size = header_len + object_lines_size(num_of_words);
+	if (!(err_val = captured ? output_capture(&out, captured, size) :
+					output_map(&out, file_name, size, keep_unchanged))) {
+		memcpy(out.buffer, header, header_len);
+
+		/*every thread gets an equal range of the words, the first one is done here*/
+		for (i = 0; i < num_of_threads; i++) {
+			ranges[i].mem_img = mem_img;
+			ranges[i].first = (int)((long)num_of_words * i / num_of_threads);
+			ranges[i].count = (int)((long)num_of_words * (i + 1) / num_of_threads) -
+							  ranges[i].first;
+			ranges[i].out = out.buffer + header_len + object_lines_size(ranges[i].first);
+			started[i] = i && !pthread_create(&threads[i], NULL, fill_object_range,
+											  &ranges[i]);
+		}
+		/*a range whose thread couldnt start is filled here too*/
+		for (i = 0; i < num_of_threads; i++)
+			if (!started[i])
+				fill_object_range(&ranges[i]);
+		for (i = 1; i < num_of_threads; i++)
+			if (started[i])
+				pthread_join(threads[i], NULL);
+
+		err_val = output_close(&out);
+		*written += out.written;
+	}
+
+	return err_val;
+}
+
+/* create_object_file : create the object file, a big one is mapped and filled in
+ * 						parallel and if that fails or the file is small it is
+ * 						written through a buffer
+ * parameters         : file_base      - the base file name
+ * 					    mem_img        - a pointer to a memory image
+ * 					    keep_unchanged - TRUE to keep a file that is the same as before
+ * 					    captured       - the output for a captured file or NULL
+ * 					    written        - a pointer to the count of characters written
+ * return             : NO_ERROR           - if created the file succesfully
+ * 				        ERROR_CREATE_FILE  - if an error occured creating the file
+ * 				        ERROR_MEMORY_ALLOC - if there was an error allocating the buffer*/
+static error_value create_object_file(const char *file_base, memory_image *mem_img,
+									  const int keep_unchanged, output_bytes *captured,
+									  long *written) {
+	error_value err_val;
+	char 		*file_name,
+				header[2 * MAX_ADDRESS_DIGITS + 2],
+				*end;
+	output_file out;
+	int 		i,
+				num_of_words = mem_img->code->ic + mem_img->data->dc;
 
 	/*create the file name with .ob extension*/
-	make_file_name(file_base, OBJECT_FILE_EXT, file_name);
+	if (!(file_name = new_file_name(file_base, OBJECT_FILE_EXT)))
+		return ERROR_MEMORY_ALLOC;
+
+	/*the header is the number of code words and of data words*/
+	end = format_number(mem_img->code->ic, OBJECT_HEADER_WIDTH, ' ', header);
+	*end++ = ' ';
+	end = format_number(mem_img->data->dc, 1, ' ', end);
+	*end++ = '\n';
+
+	if (num_of_words >= MIN_WORDS_PER_THREAD &&
+		!create_mapped_object_file(file_name, mem_img, header, end - header,
+								   keep_unchanged, captured, written)) {
+		free(file_name);
+		return NO_ERROR;
+	}
 
 	/*try to create the file*/
-	if ((fp = fopen(file_name, WRITE_APPEND))) {
-		/* if succesfully created the file itterate over the code table
-		 * and add every value to the file*/
-		fprintf(fp, "%4d %d\n", mem_img->code->ic, mem_img->data->dc);
-		for (i = 0; i < mem_img->code->ic; i++) {
-			word_to_4_special_base(
-					mem_img->code->code_entries[i].bin_machine_code,
-					base_4_word);
-			fprintf(fp, "%04d %s\n", mem_img->code->code_entries[i].address,
-									 base_4_word);
-		}
+	if (!(err_val = open_output(&out, file_name, keep_unchanged, captured))) {
+		output_text(&out, header, end - header);
 
-		/*itterate over the data table and add every value to the file*/
-		for (i = 0; i < mem_img->data->dc; i++) {
-			word_to_4_special_base(mem_img->data->data_entries[i].value,
-								   base_4_word);
-			fprintf(fp, "%04d %s\n", mem_img->data->data_entries[i].address,
-								     base_4_word);
-		}
+		/* encode the code and then the data a chunk of words at a time straight
+		 * into the buffer of the file*/
+		for (i = 0; i < num_of_words; i += OBJECT_CHUNK_WORDS)
+			output_commit(&out, encode_object_words(mem_img, i,
+					num_of_words - i < OBJECT_CHUNK_WORDS ? num_of_words - i :
+					OBJECT_CHUNK_WORDS, output_reserve(&out,
+					OBJECT_CHUNK_WORDS * MAX_OBJECT_LINE_LEN)));
 
-		fclose(fp);
-	} else /*if unable to create the file*/
-		err_val = ERROR_CREATE_FILE;
+		err_val = output_close(&out);
+		*written += out.written;
+	}
+	free(file_name);
+
+	return err_val;
+}
+
+/* write_output_file : write an output file whose contents are already in memory
+ * parameters        : file_base      - the base of the name of the file
+ * 					   ext            - the extension of the file
+ * 					   data           - the contents of the file
+ * 					   size           - the size of the file
+ * 					   keep_unchanged - TRUE to keep the file if it is the same as before
+ * return            : NO_ERROR           - if the file was written
+ * 					   ERROR_CREATE_FILE  - if the file couldnt be written
+ * 					   ERROR_MEMORY_ALLOC - if there was an error allocating*/
+error_value write_output_file(const char *file_base, const char *ext, const char *data,
+							  const size_t size, const int keep_unchanged) {
+	error_value err_val;
+	output_file out;
+	char 		*file_name;
+
+	if (!(file_name = new_file_name(file_base, ext)))
+		return ERROR_MEMORY_ALLOC;
+
+	if (!(err_val = output_open(&out, file_name, keep_unchanged))) {
+		output_text(&out, data, size);
+		err_val = output_close(&out);
+	}
+	free(file_name);
+
+	return err_val;
+}
+
+/* write_output_files : write the output files of a source whose contents are already
+ * 						in memory, the time they take and their size are added to the
+ * 						statistics of their phases
+ * parameters         : file_base      - the base of the names of the files
+ * 						outputs        - the contents of every output file, a file
+ * 										 without data isnt written
+ * 						keep_unchanged - TRUE to keep the files that are the same as before
+ * 						stats          - a pointer to the statistics of the file or NULL
+ * return             : NO_ERROR           - if the files were written
+ * 						ERROR_CREATE_FILE  - if a file couldnt be written
+ * 						ERROR_MEMORY_ALLOC - if there was an error allocating*/
+error_value write_output_files(const char *file_base, const output_bytes *outputs,
+							   const int keep_unchanged, assembly_stats *stats) {
+	error_value err_val = NO_ERROR;
+	stats_time  start;
+	int 		i;
+
+	for (i = 0; !err_val && i < NUM_OF_OUTPUTS; i++)
+		if (outputs[i].data) {
+			stats_start(stats, &start);
+			err_val = write_output_file(file_base, output_exts[i], outputs[i].data,
+										outputs[i].size, keep_unchanged);
+			stats_stop(stats, (stats_phase)(STATS_OBJECT_FILE + i), &start);
+			if (stats && !err_val)
+				stats->bytes_written += outputs[i].size;
+		}
 
 	return err_val;
 }
@@ -119,6 +377,20 @@ void make_file_name(const char *base, const char *ext, char *file_name_out) {
 	strcat(file_name_out, ext);
 }
 
+/* new_file_name : make a full file name from the base and a given extension in a
+ * 				   buffer of its size
+ * parameters    : base - the base of the file name
+ * 				   ext  - the extension of the file
+ * return        : the allocated file name or NULL if it couldnt be allocated*/
+char *new_file_name(const char *base, const char *ext) {
+	char *file_name;
+
+	if ((file_name = malloc(strlen(base) + strlen(ext) + 1)))
+		make_file_name(base, ext, file_name);
+
+	return file_name;
+}
+
 /* file_exists : check if a given file exists
  * parameters  : file_name - the name of the file to check
  * return      : NO_ERROR          - if the file exists
@@ -135,26 +407,58 @@ error_value file_exists(const char *file_name) {
 	return err_val;
 }
 /* create_files : create the object file and if needed then the entries and externals files
- * parameters   : file_base  - the base of the files names
- * 				  mem_img    - a pointer to a memory image
- * 				  symtable_p - a pointer to a symbol table
- * return       : NO_ERROR          - if the files created succesfully
- * 				  ERROR_CREATE_FILE - if there was an error creating the files*/
+ * parameters   : file_base      - the base of the files names
+ * 				  mem_img        - a pointer to a memory image
+ * 				  symtable_p     - a pointer to a symbol table
+ * 				  stats          - a pointer to the statistics of the file or NULL
+ * 				  keep_unchanged - TRUE to keep the files that are the same as before
+ * 				  captured       - the output for the contents of every output file if
+ * 				  				   they are captured instead of written, a file that
+ * 				  				   isnt needed has no data, or NULL to write them
+ * return       : NO_ERROR           - if the files created succesfully
+ * 				  ERROR_CREATE_FILE  - if there was an error creating the files
+ * 				  ERROR_MEMORY_ALLOC - if there was an error allocating a buffer*/
 error_value create_files(const char *file_base, memory_image *mem_img,
-						 symtable *symtable_p) {
+						 symtable *symtable_p, assembly_stats *stats,
+						 const int keep_unchanged, output_bytes *captured) {
 	error_value err_val = NO_ERROR;
+	stats_time  start;
+	long 		written = 0;
+	int 		i;
+
+	for (i = 0; captured && i < NUM_OF_OUTPUTS; i++) {
+		captured[i].data = NULL;
+		captured[i].size = 0;
+	}
 
 	/*try to create the object file*/
-	if (!(err_val = create_object_file(file_base, mem_img))) {
+	stats_start(stats, &start);
+	err_val = create_object_file(file_base, mem_img, keep_unchanged,
+								 captured ? &captured[OBJECT_OUTPUT] : NULL, &written);
+	stats_stop(stats, STATS_OBJECT_FILE, &start);
+	if (!err_val) {
 		/*if created then check if externals file is needed*/
-		if (mem_img->code->extern_flag)
+		if (mem_img->code->num_of_extern_refs) {
 			/*if needed try to create it*/
-			err_val = create_extern_file(file_base, mem_img->code);
+			stats_start(stats, &start);
+			err_val = create_extern_file(file_base, mem_img->code, keep_unchanged,
+										 captured ? &captured[EXTERN_OUTPUT] : NULL,
+										 &written);
+			stats_stop(stats, STATS_EXTERN_FILE, &start);
+		}
 		/*check if entries file is needed*/
-		if (!err_val && symtable_p->entry_flag)
+		if (!err_val && symtable_p->entry_flag) {
 			/*if needed try to create it*/
-			err_val = create_entry_file(file_base, symtable_p);
+			stats_start(stats, &start);
+			err_val = create_entry_file(file_base, symtable_p, keep_unchanged,
+										captured ? &captured[ENTRY_OUTPUT] : NULL,
+										&written);
+			stats_stop(stats, STATS_ENTRY_FILE, &start);
+		}
 	}
+	/*captured files are counted when they are written*/
+	if (stats && !captured)
+		stats->bytes_written = written;
 
 	return err_val;
 }
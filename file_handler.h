@@ -4,9 +4,12 @@
 #include "error.h"
 #include "memory_image.h"
 #include "symtable.h"
+#include "stats.h"
+#include "output.h"
 
 /*tokens for fopen*/
 #define READ "r"
+#define WRITE "w"
 #define WRITE_APPEND "w+"
 
 /*file extensions*/
@@ -15,8 +18,22 @@
 #define EXTERNALS_FILE_EXT ".ext"
 #define ENTRIES_FILE_EXT ".ent"
 
+/*the output files of a source in the order they are made*/
+typedef enum {
+	OBJECT_OUTPUT,
+	EXTERN_OUTPUT,
+	ENTRY_OUTPUT,
+	NUM_OF_OUTPUTS
+} output_kind;
+
+extern const char *output_exts[NUM_OF_OUTPUTS];
+
 void make_file_name(const char*, const char*, char*);
+char *new_file_name(const char*, const char*);
 error_value file_exists(const char*);
-error_value create_files(const char*, memory_image*, symtable*);
+error_value write_output_file(const char*, const char*, const char*, const size_t, const int);
+error_value write_output_files(const char*, const output_bytes*, const int, assembly_stats*);
+error_value create_files(const char*, memory_image*, symtable*, assembly_stats*, const int,
+						 output_bytes*);
 
 #endif
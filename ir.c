@@ -0,0 +1,77 @@
+#include "ir.h"
+
+/*the number of instructions and entries a new ir table has room for*/
+#define IR_TABLE_INIT_CAPACITY 64
+
+/* ir_table_init : allocate an ir table from an arena and initialize it
+ * parameters    : arena_p - a pointer to the arena that owns the table
+ * return        : if initialized succesfully return a pointer to the table
+ * 				   else return NULL*/
+ir_table *ir_table_init(arena *arena_p) {
+	ir_table *ir_p;
+
+	if ((ir_p = arena_alloc(arena_p, ARENA_IR, sizeof(ir_table)))) {
+		ir_p->num_of_instructions = 0;
+		ir_p->instructions_capacity = IR_TABLE_INIT_CAPACITY;
+		ir_p->num_of_entries = 0;
+		ir_p->entries_capacity = IR_TABLE_INIT_CAPACITY;
+		ir_p->arena = arena_p;
+
+		/*if the arrays couldnt be allocated the table cant be used*/
+		if (!(ir_p->instructions = arena_alloc(arena_p, ARENA_IR,
+				IR_TABLE_INIT_CAPACITY * sizeof(decoded_instruction))) ||
+			!(ir_p->entries = arena_alloc(arena_p, ARENA_IR,
+				IR_TABLE_INIT_CAPACITY * sizeof(entry_decl))))
+			ir_p = NULL;
+	}
+
+	return ir_p;
+}
+
+/* add_instruction : add an empty decoded instruction to the end of the ir table
+ * parameters      : ir_p - a pointer to an ir table
+ * return          : a pointer to the new instruction to fill
+ * 					 or NULL if there was an error allocating it*/
+decoded_instruction *add_instruction(ir_table *ir_p) {
+	decoded_instruction *instructions;
+
+	/*if the array is full double its size*/
+	if (ir_p->num_of_instructions == ir_p->instructions_capacity) {
+		if (!(instructions = arena_realloc(ir_p->arena, ARENA_IR, ir_p->instructions,
+				ir_p->instructions_capacity * sizeof(decoded_instruction),
+				2 * ir_p->instructions_capacity * sizeof(decoded_instruction))))
+			return NULL;
+		ir_p->instructions = instructions;
+		ir_p->instructions_capacity *= 2;
+	}
+
+	return &ir_p->instructions[ir_p->num_of_instructions++];
+}
+
+/* add_entry_decl : add an entry declaration to the end of the ir table
+ * parameters     : ir_p   - a pointer to an ir table
+ * 					symbol - the name of the entry symbol
+ * 					line   - the number of the line of the declaration
+ * return         : NO_ERROR           - if the entry was added
+ * 					ERROR_MEMORY_ALLOC - if there was an error allocating the entry*/
+error_value add_entry_decl(ir_table *ir_p, const char *symbol, const int line) {
+	entry_decl *entries;
+
+	/*if the array is full double its size*/
+	if (ir_p->num_of_entries == ir_p->entries_capacity) {
+		if (!(entries = arena_realloc(ir_p->arena, ARENA_IR, ir_p->entries,
+				ir_p->entries_capacity * sizeof(entry_decl),
+				2 * ir_p->entries_capacity * sizeof(entry_decl))))
+			return ERROR_MEMORY_ALLOC;
+		ir_p->entries = entries;
+		ir_p->entries_capacity *= 2;
+	}
+
+	/*keep a copy of the name since the line it came from is reused*/
+	if (!(ir_p->entries[ir_p->num_of_entries].symbol = arena_strdup(ir_p->arena, ARENA_IR,
+																	symbol)))
+		return ERROR_MEMORY_ALLOC;
+	ir_p->entries[ir_p->num_of_entries++].line = line;
+
+	return NO_ERROR;
+}
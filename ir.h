@@ -0,0 +1,56 @@
+#ifndef IR_H
+#define IR_H
+
+#include "defs.h"
+#include "error.h"
+#include "arena.h"
+
+/*the most operands an instruction can have*/
+#define MAX_OPERANDS 2
+
+/*a struct representing a decoded operand of an instruction*/
+typedef struct{
+	addressing_mode mode;
+	int value;
+	int word;
+	int pending;
+	const char *symbol;
+	const char *extern_name;
+} decoded_operand;
+
+/* a struct representing a decoded instruction
+ * value of an operand is its immediate value, its register number or its array
+ * index, symbol is the symbol of a DIRECT or INDEX operand, word is the index of
+ * its word in the code table and pending is set while that word still waits for
+ * the symbol to get its final value*/
+typedef struct{
+	int op;
+	int num_of_operands;
+	int word;
+	int line;
+	decoded_operand operands[MAX_OPERANDS];
+} decoded_instruction;
+
+/*a struct representing an entry declaration, handled once all symbols are known*/
+typedef struct{
+	const char *symbol;
+	int line;
+} entry_decl;
+
+/* a struct representing what the first pass keeps for the second pass
+ * the instructions and entries are each in the order of their lines*/
+typedef struct{
+	decoded_instruction *instructions;
+	int num_of_instructions;
+	int instructions_capacity;
+	entry_decl *entries;
+	int num_of_entries;
+	int entries_capacity;
+	arena *arena;
+} ir_table;
+
+ir_table *ir_table_init(arena*);
+decoded_instruction *add_instruction(ir_table*);
+error_value add_entry_decl(ir_table*, const char*, const int);
+
+#endif
@@ -0,0 +1,138 @@
+#include "job.h"
+#include "file_handler.h"
+#include "pass1.h"
+#include "pass2.h"
+
+/* file_job_init : initialize the assembly of a file
+ * parameters    : job       - a pointer to the file job
+ * 				   file_base - the base name of the file as it was given
+ * return        : NO_ERROR           - if the job is ready
+ * 				   ERROR_MEMORY_ALLOC - if the name of the file couldnt be allocated*/
+error_value file_job_init(file_job *job, const char *file_base) {
+	job->file_base = file_base;
+	job->size = 0;
+	job->err_val = NO_ERROR;
+	job->stats = NULL;
+	job->worker = 0;
+	job->cache = NULL;
+	job->keep_unchanged = FALSE;
+	job->source = NULL;
+	job->captured = NULL;
+	diagnostics_init(&job->diag);
+
+	/*create a full file name with .as extention from provided base name*/
+	if (!(job->file_name = new_file_name(file_base, CODE_FILE_EXT)))
+		return ERROR_MEMORY_ALLOC;
+
+	return NO_ERROR;
+}
+
+/* assemble_file : assemble a file and create its output files
+ * parameters    : context - a pointer to the assembly context to use for the file
+ * 				   job     - a pointer to the file job, the result is kept in it
+ * return        :*/
+void assemble_file(assembly_context *context, file_job *job) {
+	error_value	 err_val;
+	source_file	 source;
+	stats_time	 start,
+				 total;
+	output_bytes outputs[NUM_OF_OUTPUTS];
+	char 		 key[CACHE_KEY_LEN + 1];
+	int 		 cached = FALSE,
+				 i;
+
+	/*the errors of the file are kept until the file is reported*/
+	context->diag = &job->diag;
+	context->stats = job->stats;
+	stats_start(job->stats, &total);
+
+	/* try to map the file or read it, the file is opened once so a pipe can be
+	 * given as well, if it cant be opened then it doesnt exist, a source that
+	 * was given in memory is used as it is*/
+	stats_start(job->stats, &start);
+	if (job->source) {
+		source = *job->source;
+		err_val = NO_ERROR;
+	} else
+		err_val = source_open(&source, job->file_name);
+	stats_stop(job->stats, STATS_READ, &start);
+	if (!err_val) {
+		/* a source that was assembled before has its output files in the cache,
+		 * the cache holds files so captured outputs dont use it*/
+		if (job->cache && !job->captured) {
+			cache_key(source.data, source.size, key);
+			cached = cache_fetch(job->cache, key, job->file_base,
+								 job->keep_unchanged, job->stats);
+			if (cached && job->stats)
+				job->stats->cache_hit = TRUE;
+		}
+
+		/* if file was successfully opened release what the previous file used
+		 * and try to initialize the memory image and the symtable, then
+		 * reserve room for the code we expect from a file of this size
+		 * and execute first pass on the given file*/
+		if (!cached && !(err_val = context_reset(context))) {
+			stats_start(job->stats, &start);
+			if (!(err_val = memory_image_reserve(context->mem_img, source.size)))
+				err_val = pass1_execute(&source, context, job->file_name);
+			stats_stop(job->stats, STATS_PASS1, &start);
+
+			/* if no errors occured during the first pass then prepare for
+			 * the second pass and execute it to complete the words that
+			 * refer to symbols*/
+			if (!err_val) {
+				stats_start(job->stats, &start);
+				pass2_prep(context);
+				stats_stop(job->stats, STATS_PASS2_PREP, &start);
+				stats_start(job->stats, &start);
+				err_val = pass2_execute(context, job->file_name);
+				stats_stop(job->stats, STATS_PASS2, &start);
+
+				/* if no error occured during the second pass the create
+				 * the object file and if needed then the externals and
+				 * entries files, with a cache they are made in memory and
+				 * written from there so the same bytes are kept for the
+				 * next time*/
+				if (!err_val && job->cache && !job->captured) {
+					if (!(err_val = create_files(job->file_base, context->mem_img,
+												 context->symtable, job->stats,
+												 job->keep_unchanged, outputs)) &&
+						!(err_val = write_output_files(job->file_base, outputs,
+													   job->keep_unchanged, job->stats)))
+						cache_store(job->cache, key, outputs);
+					for (i = 0; i < NUM_OF_OUTPUTS; i++)
+						free(outputs[i].data);
+				} else if (!err_val)
+					err_val = create_files(job->file_base, context->mem_img,
+										   context->symtable, job->stats,
+										   job->keep_unchanged, job->captured);
+			}
+
+			/*the counters are read from the tables of the file*/
+			if (job->stats)
+				stats_collect(job->stats, context->arena, context->mem_img,
+							  context->symtable);
+		}
+		source_close(&source);
+	}
+
+	stats_stop(job->stats, STATS_TOTAL, &total);
+	context->diag = NULL;
+	context->stats = NULL;
+	job->err_val = err_val;
+}
+
+/* file_job_report : print the errors of a file and the result of its assembly
+ * 				     and release the job
+ * parameters      : job - a pointer to the file job
+ * return          :*/
+void file_job_report(file_job *job) {
+	diagnostics_flush(&job->diag);
+	print_error(job->err_val, job->file_name, 0);
+	printf("\n");
+	if (job->stats && job->stats->format != STATS_OFF)
+		stats_print(job->stats, job->file_name);
+
+	free(job->file_name);
+	job->file_name = NULL;
+}
@@ -0,0 +1,41 @@
+#ifndef JOB_H
+#define JOB_H
+
+#include "defs.h"
+#include "error.h"
+#include "context.h"
+#include "stats.h"
+#include "cache.h"
+#include "source.h"
+#include "output.h"
+
+/* a struct representing the assembly of one of the files given to the assembler
+ * its errors are kept in diag until they are printed in the order of the files
+ * stats points to its statistics when they were asked for or else it is NULL
+ * worker is the number of the thread that assembled it, 0 for the main thread
+ * cache points to the build cache its outputs are looked up in and kept in, NULL
+ * if there is no cache
+ * keep_unchanged is TRUE if output files that are the same as before are left as
+ * they are so their times dont change
+ * source is the source when it was given in memory instead of by its name, the
+ * assembly closes it, and captured is where the output files are kept when they
+ * arent written, both are NULL by default*/
+typedef struct{
+	const char *file_base;
+	char *file_name;
+	long size;
+	error_value err_val;
+	diagnostics diag;
+	assembly_stats *stats;
+	int worker;
+	const build_cache *cache;
+	int keep_unchanged;
+	source_file *source;
+	output_bytes *captured;
+} file_job;
+
+error_value file_job_init(file_job*, const char*);
+void assemble_file(assembly_context*, file_job*);
+void file_job_report(file_job*);
+
+#endif
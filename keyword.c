@@ -0,0 +1,164 @@
+#include "keyword.h"
+
+/*the number of keywords*/
+#define NUM_OF_KEYWORDS 29
+/*the number of slots in the keywords hash table (a power of 2)*/
+#define KEYWORD_SLOTS 64
+/*the shortest and the longest keywords*/
+#define MIN_KEYWORD_LEN 2
+#define MAX_KEYWORD_LEN 7
+
+/* the hash of a keyword from its first and last characters and its length
+ * it has no collisions between the keywords so every lookup is one probe*/
+#define keyword_hash(str, len) \
+	((7 * (unsigned char)(str)[0] + 5 * (unsigned char)(str)[(len) - 1] + 3 * (len)) & \
+	 (KEYWORD_SLOTS - 1))
+
+/* a table of operations supported by the cpu with their value, number of parameters
+ * and allowed source and estination addressing modes while each mode turnes a different
+ * bit for bitwise operators to use
+ * for example if an operation supports the DIRECT source addressing mode
+ * the command mode & op->allowed_src_mode will give a non zero result
+ * which means it supports this mode*/
+static const op_entry op_table[] = {
+		{ 0, 2, IMMEDIATE | DIRECT | INDEX |  REGISTER, DIRECT | INDEX |  REGISTER},
+		{ 1, 2, IMMEDIATE | DIRECT | INDEX |  REGISTER, IMMEDIATE | DIRECT | INDEX |  REGISTER},
+		{ 2, 2, IMMEDIATE | DIRECT | INDEX |  REGISTER, DIRECT | INDEX |  REGISTER},
+		{ 3, 2, IMMEDIATE | DIRECT | INDEX |  REGISTER, DIRECT | INDEX |  REGISTER},
+		{ 4, 1, NONE, DIRECT | INDEX |  REGISTER},
+		{ 5, 1, NONE, DIRECT | INDEX |  REGISTER},
+		{ 6, 2, DIRECT | INDEX, DIRECT | INDEX |  REGISTER},
+		{ 7, 1, NONE, DIRECT | INDEX |  REGISTER},
+		{ 8, 1, NONE, DIRECT | INDEX |  REGISTER},
+		{ 9, 1, NONE, DIRECT | REGISTER},
+		{10, 1, NONE, DIRECT | REGISTER},
+		{11, 1, NONE, DIRECT | INDEX |  REGISTER},
+		{12, 1, NONE, IMMEDIATE | DIRECT | INDEX |  REGISTER},
+		{13, 1, NONE, DIRECT | REGISTER},
+		{14, 0, NONE, NONE},
+		{15, 0, NONE, NONE}
+};
+
+/*a table of all the keywords, the operations, the registers and the directives*/
+static const keyword keyword_table[NUM_OF_KEYWORDS] = {
+		{"mov" , OPERATION_KEYWORD, &op_table[0] , -1, NO_DIRECTIVE},
+		{"cmp" , OPERATION_KEYWORD, &op_table[1] , -1, NO_DIRECTIVE},
+		{"add" , OPERATION_KEYWORD, &op_table[2] , -1, NO_DIRECTIVE},
+		{"sub" , OPERATION_KEYWORD, &op_table[3] , -1, NO_DIRECTIVE},
+		{"not" , OPERATION_KEYWORD, &op_table[4] , -1, NO_DIRECTIVE},
+		{"clr" , OPERATION_KEYWORD, &op_table[5] , -1, NO_DIRECTIVE},
+		{"lea" , OPERATION_KEYWORD, &op_table[6] , -1, NO_DIRECTIVE},
+		{"inc" , OPERATION_KEYWORD, &op_table[7] , -1, NO_DIRECTIVE},
+		{"dec" , OPERATION_KEYWORD, &op_table[8] , -1, NO_DIRECTIVE},
+		{"jmp" , OPERATION_KEYWORD, &op_table[9] , -1, NO_DIRECTIVE},
+		{"bne" , OPERATION_KEYWORD, &op_table[10], -1, NO_DIRECTIVE},
+		{"red" , OPERATION_KEYWORD, &op_table[11], -1, NO_DIRECTIVE},
+		{"prn" , OPERATION_KEYWORD, &op_table[12], -1, NO_DIRECTIVE},
+		{"jsr" , OPERATION_KEYWORD, &op_table[13], -1, NO_DIRECTIVE},
+		{"rts" , OPERATION_KEYWORD, &op_table[14], -1, NO_DIRECTIVE},
+		{"stop", OPERATION_KEYWORD, &op_table[15], -1, NO_DIRECTIVE},
+		{"r0"  , REGISTER_KEYWORD , NULL, 0, NO_DIRECTIVE},
+		{"r1"  , REGISTER_KEYWORD , NULL, 1, NO_DIRECTIVE},
+		{"r2"  , REGISTER_KEYWORD , NULL, 2, NO_DIRECTIVE},
+		{"r3"  , REGISTER_KEYWORD , NULL, 3, NO_DIRECTIVE},
+		{"r4"  , REGISTER_KEYWORD , NULL, 4, NO_DIRECTIVE},
+		{"r5"  , REGISTER_KEYWORD , NULL, 5, NO_DIRECTIVE},
+		{"r6"  , REGISTER_KEYWORD , NULL, 6, NO_DIRECTIVE},
+		{"r7"  , REGISTER_KEYWORD , NULL, 7, NO_DIRECTIVE},
+		{".data"  , DIRECTIVE_KEYWORD, NULL, -1, DATA_DIRECTIVE},
+		{".string", DIRECTIVE_KEYWORD, NULL, -1, STRING_DIRECTIVE},
+		{".entry" , DIRECTIVE_KEYWORD, NULL, -1, ENTRY_DIRECTIVE},
+		{".extern", DIRECTIVE_KEYWORD, NULL, -1, EXTERN_DIRECTIVE},
+		{".define", DEFINE_KEYWORD   , NULL, -1, NO_DIRECTIVE}
+};
+
+/* the keywords hash table, the index of the keyword in every slot or -1
+ * generated from keyword_table with keyword_hash by make keyword_slots, the
+ * build of keyword.o fails while it doesnt match keyword_table*/
+static const signed char keyword_slots[KEYWORD_SLOTS] = {
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  4,
+		28, -1,  0, -1, 16, -1, -1,  7,  3, 17, 25, 11, -1, -1, 18,  9,
+		-1, 15,  6, 19,  2, -1, 14, -1, 20, 13, -1, -1, -1, 21,  1, -1,
+		10, 26, 22, -1,  8, -1, 24, 23,  5, -1, -1, -1, -1, 27, -1, 12
+};
+
+/* find_keyword : classify a string as a keyword with one probe in the keywords table
+ * parameters   : str - the string to classify
+ * return       : a pointer to the keyword if the string is one
+ * 				  else return NULL*/
+const keyword *find_keyword(const char *str) {
+	size_t len;
+
+	/*a string longer than every keyword is not measured to its end*/
+	for (len = 0; len <= MAX_KEYWORD_LEN && str[len]; len++);
+
+	return find_keyword_n(str, len);
+}
+
+/* find_keyword_n : classify a part of a longer string as a keyword
+ * parameters     : str - the start of the string to classify
+ * 					len - the length of the string
+ * return         : a pointer to the keyword if the string is one
+ * 					else return NULL*/
+const keyword *find_keyword_n(const char *str, const size_t len) {
+	int slot;
+
+	/*only a string of the length of a keyword can be one*/
+	if (len < MIN_KEYWORD_LEN || len > MAX_KEYWORD_LEN)
+		return NULL;
+
+	slot = keyword_slots[keyword_hash(str, len)];
+
+	return slot >= 0 && !strncmp(keyword_table[slot].name, str, len) &&
+		   !keyword_table[slot].name[len] ? &keyword_table[slot] : NULL;
+}
+
+#ifdef KEYWORD_GEN
+/*the number of slots written on a line of the generated table*/
+#define SLOTS_PER_LINE 16
+
+/* main : rebuild the keywords hash table from keyword_table and keyword_hash, write it
+ * 		  in the form of keyword_slots and compare it with keyword_slots
+ * return : 0 - if keyword_slots is up to date
+ * 			1 - if two keywords share a slot or keyword_slots has to be replaced*/
+int main() {
+	signed char slots[KEYWORD_SLOTS];
+	int         i,
+				slot,
+				len,
+				err_flag = FALSE;
+
+	memset(slots, -1, sizeof(slots));
+	for (i = 0; i < NUM_OF_KEYWORDS; i++) {
+		len = strlen(keyword_table[i].name);
+		if (len < MIN_KEYWORD_LEN || len > MAX_KEYWORD_LEN) {
+			fprintf(stderr, "keyword %s is out of the keyword lengths\n",
+					keyword_table[i].name);
+			err_flag = TRUE;
+		}
+		slot = keyword_hash(keyword_table[i].name, len);
+		if (slots[slot] >= 0) {
+			fprintf(stderr, "keywords %s and %s share slot %d, keyword_hash has to change\n",
+					keyword_table[slots[slot]].name, keyword_table[i].name, slot);
+			err_flag = TRUE;
+		}
+		slots[slot] = i;
+	}
+
+	/*write the table so it can replace keyword_slots as is*/
+	printf("static const signed char keyword_slots[KEYWORD_SLOTS] = {\n");
+	for (i = 0; i < KEYWORD_SLOTS; i++)
+		printf("%s%2d%s", i % SLOTS_PER_LINE ? " " : "\t\t", slots[i],
+			   i == KEYWORD_SLOTS - 1 ? "\n" : i % SLOTS_PER_LINE == SLOTS_PER_LINE - 1 ?
+			   ",\n" : ",");
+	printf("};\n");
+
+	if (!err_flag && memcmp(slots, keyword_slots, sizeof(slots))) {
+		fprintf(stderr, "keyword_slots doesnt match keyword_table, replace it with the "
+				"table make keyword_slots writes\n");
+		err_flag = TRUE;
+	}
+
+	return err_flag;
+}
+#endif
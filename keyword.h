@@ -0,0 +1,45 @@
+#ifndef KEYWORD_H
+#define KEYWORD_H
+
+#include "defs.h"
+
+/*enum for the kinds of keywords*/
+typedef enum{
+	OPERATION_KEYWORD,
+	REGISTER_KEYWORD,
+	DIRECTIVE_KEYWORD,
+	DEFINE_KEYWORD
+} keyword_kind;
+
+/*enum for the directives*/
+typedef enum{
+	NO_DIRECTIVE,
+	DATA_DIRECTIVE,
+	STRING_DIRECTIVE,
+	ENTRY_DIRECTIVE,
+	EXTERN_DIRECTIVE
+} directive_id;
+
+/*a struct representing an operation supported by the cpu*/
+typedef struct {
+	int value;
+	int num_of_parameters;
+	int allowed_src_mode;
+	int allowed_dest_mode;
+} op_entry;
+
+/* a struct representing a keyword of the language with everything that is known
+ * about it, op is set for an operation, reg for a register (else -1) and
+ * directive for a directive*/
+typedef struct {
+	const char *name;
+	keyword_kind kind;
+	const op_entry *op;
+	int reg;
+	directive_id directive;
+} keyword;
+
+const keyword *find_keyword(const char*);
+const keyword *find_keyword_n(const char*, const size_t);
+
+#endif
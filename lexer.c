@@ -0,0 +1,72 @@
+#include "lexer.h"
+
+/* lex_line   : split a line into tokens in a single scan, a comma is a token of its
+ * 				own and every other run of characters between blanks and commas is a
+ * 				word, the tokens are found from the blanks and commas the pre-scan of
+ * 				the line marked and the line itself is not changed
+ * parameters : line - the line to split
+ * 				scan - a pointer to the pre-scan of the line
+ * 				list - a pointer to the token list to fill
+ * return     :*/
+void lex_line(const char *line, const line_scan *scan, token_list *list) {
+	unsigned int separators[SCAN_BLOCKS];
+	token        *tok;
+	int 	     pos,
+				 i;
+
+	/*a word ends at a blank or at a comma*/
+	for (i = 0; i < SCAN_BLOCKS; i++)
+		separators[i] = scan->blanks[i] | scan->commas[i];
+
+	for (list->num_of_tokens = 0, pos = scan->first;
+		 pos < scan->len && list->num_of_tokens < MAX_TOKENS;) {
+		tok = &list->tokens[list->num_of_tokens++];
+		tok->offset = pos;
+		tok->joined = list->num_of_tokens > 1 && !char_is(line[pos - 1], CHAR_BLANK);
+		if (line[pos] == ',') {
+			tok->kind = COMMA_TOKEN;
+			pos++;
+		} else {
+			tok->kind = WORD_TOKEN;
+			pos = scan_next(separators, pos, scan->len, TRUE);
+		}
+		tok->len = pos - tok->offset;
+
+		/*blanks only separate the tokens around them*/
+		pos = scan_next(scan->blanks, pos, scan->len, FALSE);
+	}
+}
+
+/* run_end    : find where a run of tokens with no whitespace between them ends
+ * parameters : list  - a pointer to a token list
+ * 				first - the index of the first token of the run
+ * return     : the index of the token after the run*/
+int run_end(const token_list *list, const int first) {
+	int i;
+
+	for (i = first + 1; i < list->num_of_tokens && list->tokens[i].joined; i++);
+
+	return i;
+}
+
+/* join_tokens : move the text of tokens in the line so they follow the first of
+ * 				 them without the whitespace between them, the text is not terminated
+ * parameters  : line          - the line the tokens were read from
+ * 				 tokens        - the tokens to join
+ * 				 num_of_tokens - the number of tokens to join
+ * return      : the length of the joined text*/
+int join_tokens(char *line, const token *tokens, const int num_of_tokens) {
+	int i,
+		len;
+
+	if (!num_of_tokens)
+		return 0;
+
+	/*a token that already follows the text before it stays in place*/
+	for (i = 1, len = tokens[0].len; i < num_of_tokens; len += tokens[i++].len)
+		if (tokens[i].offset != tokens[0].offset + len)
+			memmove(line + tokens[0].offset + len, line + tokens[i].offset,
+					tokens[i].len);
+
+	return len;
+}
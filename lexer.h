@@ -0,0 +1,35 @@
+#ifndef LEXER_H
+#define LEXER_H
+
+#include "defs.h"
+#include "scan.h"
+
+/*the most tokens a line can have, every character of the line can be a token*/
+#define MAX_TOKENS (MAX_LINE_LEN + 2)
+
+/*enum of the kinds of tokens*/
+typedef enum{
+	WORD_TOKEN,
+	COMMA_TOKEN
+}token_kind;
+
+/* a struct representing a token, a span of the line it was read from
+ * joined is set if there is no whitespace between the token and the one before it*/
+typedef struct{
+	int offset;
+	int len;
+	token_kind kind;
+	int joined;
+}token;
+
+/*a struct representing the tokens of a line in the order they appear*/
+typedef struct{
+	token tokens[MAX_TOKENS];
+	int num_of_tokens;
+}token_list;
+
+void lex_line(const char*, const line_scan*, token_list*);
+int run_end(const token_list*, const int);
+int join_tokens(char*, const token*, const int);
+
+#endif
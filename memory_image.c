@@ -1,26 +1,32 @@
 #include "memory_image.h"
 
-/* memory_image_init : allocate a memory image and initialize it
- * parameters        :
+/* a low estimate of the number of source bytes that produce one code word
+ * (test1.as has about 17) so the reservation rarely has to grow again*/
+#define SOURCE_BYTES_PER_CODE_WORD 16
+
+/* memory_image_init : allocate a memory image from an arena and initialize it
+ * parameters        : arena_p - a pointer to the arena that owns the memory image
  * return            : if initialized succesfully return a pointer to the memory image
  * 					   else return NULL
  */
-memory_image *memory_image_init() {
+memory_image *memory_image_init(arena *arena_p) {
 	memory_image *mem_img;
 
-	/* try to initialize a code table and data table and if succefulll then return a pointer
-	 * to the memory image else return NULL*/
-	return (mem_img = malloc(sizeof(memory_image))) &&
-		   (mem_img->code = code_table_init()) &&
-		   (mem_img->data = data_table_init()) ? mem_img : NULL;
+	/* try to initialize a code table, data table and ir table and if succefulll
+	 * then return a pointer to the memory image else return NULL*/
+	return (mem_img = arena_alloc(arena_p, ARENA_OTHER, sizeof(memory_image))) &&
+		   (mem_img->code = code_table_init(arena_p)) &&
+		   (mem_img->data = data_table_init(arena_p)) &&
+		   (mem_img->ir = ir_table_init(arena_p)) ? mem_img : NULL;
 }
 
-/* memory_image_free : free a prevoiusly allocated memory_image
- * parameters        : mem_img - a pointer to a memory image to free*/
-void memory_image_free(memory_image *mem_img) {
-	if(mem_img){
-		data_table_free(mem_img->data);
-		code_table_free(mem_img->code);
-		free(mem_img);
-	}
+/* memory_image_reserve : reserve room in the code table for the words we expect
+ * 						  a source file of the given size to produce
+ * parameters           : mem_img     - a pointer to a memory image
+ * 						  source_size - the size of the source file in bytes
+ * return               : NO_ERROR           - if the room was reserved
+ * 						  ERROR_MEMORY_ALLOC - if there was an error allocating the room*/
+error_value memory_image_reserve(memory_image *mem_img, const long source_size) {
+	return code_table_reserve(mem_img->code,
+			(int)(source_size / SOURCE_BYTES_PER_CODE_WORD));
 }
@@ -4,14 +4,17 @@
 #include "defs.h"
 #include "data.h"
 #include "code.h"
+#include "arena.h"
+#include "ir.h"
 
 /*a struct representing a memory image*/
 typedef struct{
 	code_table *code;
 	data_table *data;
+	ir_table *ir;
 }memory_image;
 
-memory_image *memory_image_init();
-void memory_image_free(memory_image*);
+memory_image *memory_image_init(arena*);
+error_value memory_image_reserve(memory_image*, const long);
 
 #endif
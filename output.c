@@ -0,0 +1,432 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "output.h"
+
+/*the permissions of a new output file before the umask*/
+#define OUTPUT_FILE_MODE 0666
+/*the extension of a file that replaces an output file and the most characters
+ * that are added to the name of the output file for it*/
+#define TEMP_FILE_EXT ".tmp"
+#define MAX_TEMP_SUFFIX_LEN 64
+/*the most decimal digits of a number*/
+#define MAX_NUMBER_DIGITS 10
+
+/*the decimal digits of every number below 100 with a leading zero*/
+const char decimal_pairs[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/*the powers of ten a number is compared to for the number of its digits*/
+static const int powers_of_ten[MAX_NUMBER_DIGITS] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/* write_all  : write characters to an output file, a write may take only part of
+ * 				them, if writing fails the error is kept
+ * parameters : out  - a pointer to the output file
+ * 				data - the characters to write
+ * 				len  - the number of characters
+ * return     :*/
+static void write_all(output_file *out, const char *data, const size_t len) {
+	size_t  pos;
+	ssize_t part;
+	char 	*grown;
+
+	/*a captured output grows by the whole buffer so it is copied only once*/
+	if (out->memory) {
+		if (!len || out->err)
+			return;
+		if (!(grown = realloc(out->memory->data, out->memory->size + len)))
+			out->err = ERROR_MEMORY_ALLOC;
+		else {
+			memcpy(grown + out->memory->size, data, len);
+			out->memory->data = grown;
+			out->memory->size += len;
+			out->written += len;
+		}
+		return;
+	}
+
+	for (pos = 0; !out->err && pos < len; pos += part)
+		if ((part = write(out->fd, data + pos, len - pos)) <= 0)
+			out->err = ERROR_CREATE_FILE;
+		else
+			out->written += part;
+}
+
+/* open_temp  : create the file that replaces a file when it is closed, it is next
+ * 				to the file so it can be renamed over it and it keeps its permissions
+ * parameters : out - a pointer to the output file
+ * return     : NO_ERROR           - if the file was created
+ * 				ERROR_CREATE_FILE  - if the file couldnt be created
+ * 				ERROR_MEMORY_ALLOC - if there was an error allocating its name*/
+static error_value open_temp(output_file *out) {
+	if (!(out->temp_name = malloc(strlen(out->file_name) + MAX_TEMP_SUFFIX_LEN)))
+		return ERROR_MEMORY_ALLOC;
+	/*the name is unique to the process and to the output file while it is open*/
+	sprintf(out->temp_name, "%s.%ld.%lx" TEMP_FILE_EXT, out->file_name, (long)getpid(),
+			(unsigned long)out);
+
+	if ((out->fd = open(out->temp_name, O_RDWR | O_CREAT | O_TRUNC, OUTPUT_FILE_MODE)) < 0) {
+		free(out->temp_name);
+		out->temp_name = NULL;
+		return ERROR_CREATE_FILE;
+	}
+	if (out->old_mode >= 0)
+		fchmod(out->fd, out->old_mode);
+
+	return NO_ERROR;
+}
+
+/* read_old   : read the next characters of the existing file of an output file
+ * parameters : out - a pointer to the output file
+ * 				len - the number of characters to read, at most OUTPUT_BUFFER_SIZE
+ * return     : the number of characters read, less if the file ended*/
+static size_t read_old(output_file *out, const size_t len) {
+	size_t  pos;
+	ssize_t part;
+
+	for (pos = 0; pos < len && (part = read(out->old_fd, out->old_buffer + pos,
+											len - pos)) > 0; pos += part);
+
+	return pos;
+}
+
+/* same_as_old : compare the buffer of an output file to the next characters of the
+ * 				 existing file
+ * parameters  : out - a pointer to the output file
+ * return      : TRUE if they are the same else FALSE*/
+static int same_as_old(output_file *out) {
+	size_t pos,
+		   part;
+
+	for (pos = 0; pos < out->len; pos += part) {
+		part = out->len - pos < OUTPUT_BUFFER_SIZE ? out->len - pos : OUTPUT_BUFFER_SIZE;
+		if (read_old(out, part) != part || memcmp(out->buffer + pos, out->old_buffer, part))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* stop_comparing : start the file that replaces the existing file of an output
+ * 					file once they differ, with the start of the existing file that
+ * 					was the same
+ * parameters     : out - a pointer to the output file
+ * return         :*/
+static void stop_comparing(output_file *out) {
+	long   left;
+	size_t part;
+
+	if (!(out->err = open_temp(out)) && lseek(out->old_fd, 0, SEEK_SET))
+		out->err = ERROR_CREATE_FILE;
+	for (left = out->compared; !out->err && left > 0; left -= part) {
+		part = left < OUTPUT_BUFFER_SIZE ? left : OUTPUT_BUFFER_SIZE;
+		if (read_old(out, part) != part)
+			out->err = ERROR_CREATE_FILE;
+		else
+			write_all(out, out->old_buffer, part);
+	}
+
+	close(out->old_fd);
+	out->old_fd = -1;
+}
+
+/* output_flush : write the buffer of an output file to the file and empty it, if
+ * 				  writing fails the error is kept and the rest is discarded
+ * 				  while the output is the same as the existing file nothing is written
+ * parameters   : out - a pointer to the output file
+ * return       :*/
+static void output_flush(output_file *out) {
+	if (out->old_fd >= 0 && !out->err) {
+		if (same_as_old(out)) {
+			out->compared += out->len;
+			out->len = 0;
+			return;
+		}
+		stop_comparing(out);
+	}
+
+	write_all(out, out->buffer, out->len);
+	out->len = 0;
+}
+
+/* open_old   : open the existing file of an output file that is kept when it is
+ * 				unchanged and keep its permissions
+ * parameters : out       - a pointer to the output file
+ * 				file_name - the name of the file
+ * 				size      - the output for the size of the existing file
+ * return     : TRUE if there is an existing file else FALSE*/
+static int open_old(output_file *out, const char *file_name, off_t *size) {
+	struct stat st;
+
+	out->file_name = file_name;
+	if ((out->old_fd = open(file_name, O_RDONLY)) < 0)
+		return FALSE;
+	if (fstat(out->old_fd, &st) || !S_ISREG(st.st_mode)) {
+		close(out->old_fd);
+		out->old_fd = -1;
+		return FALSE;
+	}
+	out->old_mode = st.st_mode & 07777;
+	*size = st.st_size;
+
+	return TRUE;
+}
+
+/* output_reset : set an output file to have nothing written and nothing to compare
+ * parameters   : out - a pointer to the output file
+ * return       :*/
+static void output_reset(output_file *out) {
+	out->len = 0;
+	out->written = 0;
+	out->err = NO_ERROR;
+	out->mapped = FALSE;
+	out->buffer = NULL;
+	out->file_name = NULL;
+	out->temp_name = NULL;
+	out->fd = out->old_fd = out->old_mode = -1;
+	out->compared = 0;
+	out->old_buffer = NULL;
+	out->memory = NULL;
+}
+
+/* output_open : create an output file, an existing file is truncated, or if it is
+ * 				 kept when it is unchanged it is compared to the output and only
+ * 				 replaced if they differ
+ * parameters  : out            - a pointer to the output file to open
+ * 				 file_name      - the name of the file, kept until it is closed
+ * 				 keep_unchanged - TRUE to keep the existing file if it is unchanged
+ * return      : NO_ERROR           - if the file is ready to be written
+ * 				 ERROR_CREATE_FILE  - if the file couldnt be created
+ * 				 ERROR_MEMORY_ALLOC - if there was an error allocating the buffer*/
+error_value output_open(output_file *out, const char *file_name, const int keep_unchanged) {
+	error_value err_val = NO_ERROR;
+	off_t 		size;
+
+	output_reset(out);
+	if (!(out->buffer = malloc(OUTPUT_BUFFER_SIZE)))
+		return ERROR_MEMORY_ALLOC;
+
+	if (!keep_unchanged) {
+		if ((out->fd = open(file_name, O_WRONLY | O_CREAT | O_TRUNC, OUTPUT_FILE_MODE)) < 0)
+			err_val = ERROR_CREATE_FILE;
+	/*without an existing file or room to read it the output goes to a new file*/
+	} else if (!open_old(out, file_name, &size) ||
+			   !(out->old_buffer = malloc(OUTPUT_BUFFER_SIZE))) {
+		if (out->old_fd >= 0)
+			close(out->old_fd);
+		out->old_fd = -1;
+		err_val = open_temp(out);
+	}
+
+	if (err_val) {
+		free(out->buffer);
+		free(out->old_buffer);
+	}
+
+	return err_val;
+}
+
+/* output_map : create an output file of an exact size and map it to memory so it
+ * 				can be filled in place, from several threads if needed, the whole
+ * 				file is the buffer and it is written when it is closed
+ * 				a file that is kept when it is unchanged is replaced if it has another
+ * 				size, if it has the same size the output is made in memory and is
+ * 				compared to it when it is closed
+ * parameters : out            - a pointer to the output file to map
+ * 				file_name      - the name of the file, kept until it is closed
+ * 				size           - the size of the file, more than 0
+ * 				keep_unchanged - TRUE to keep the existing file if it is unchanged
+ * return     : NO_ERROR           - if the file is mapped
+ * 				ERROR_CREATE_FILE  - if the file couldnt be created or mapped
+ * 				ERROR_MEMORY_ALLOC - if there was an error allocating*/
+error_value output_map(output_file *out, const char *file_name, const size_t size,
+					   const int keep_unchanged) {
+	error_value err_val;
+	off_t 		old_size;
+	void 		*data;
+
+	output_reset(out);
+	if (!keep_unchanged) {
+		if ((out->fd = open(file_name, O_RDWR | O_CREAT | O_TRUNC, OUTPUT_FILE_MODE)) < 0)
+			return ERROR_CREATE_FILE;
+	} else if (open_old(out, file_name, &old_size) && old_size == (off_t)size) {
+		/*the output is compared a buffer at a time when it is flushed*/
+		if (!(out->buffer = malloc(size)) ||
+			!(out->old_buffer = malloc(OUTPUT_BUFFER_SIZE))) {
+			free(out->buffer);
+			close(out->old_fd);
+			return ERROR_MEMORY_ALLOC;
+		}
+		out->len = size;
+		return NO_ERROR;
+	} else {
+		if (out->old_fd >= 0)
+			close(out->old_fd);
+		out->old_fd = -1;
+		if ((err_val = open_temp(out)))
+			return err_val;
+	}
+	out->len = size;
+	out->mapped = TRUE;
+
+	/*the file must have its size before the pages of the mapping are written*/
+	if (ftruncate(out->fd, size) ||
+		(data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, out->fd, 0))
+		== MAP_FAILED) {
+		close(out->fd);
+		if (out->temp_name) {
+			unlink(out->temp_name);
+			free(out->temp_name);
+		}
+		return ERROR_CREATE_FILE;
+	}
+	out->buffer = data;
+
+	return NO_ERROR;
+}
+
+/* output_reserve : make room at the end of the buffer of an output file, the
+ * 					characters are added with output_commit
+ * parameters     : out - a pointer to the output file
+ * 					len - the number of characters to make room for, at most
+ * 						  OUTPUT_BUFFER_SIZE
+ * return         : a pointer to where the characters go*/
+char *output_reserve(output_file *out, const size_t len) {
+	if (out->len + len > OUTPUT_BUFFER_SIZE)
+		output_flush(out);
+
+	return out->buffer + out->len;
+}
+
+/* output_commit : add the characters written after output_reserve to the buffer
+ * parameters    : out - a pointer to the output file
+ * 				   end - a pointer to the character after the last one written
+ * return        :*/
+void output_commit(output_file *out, const char *end) {
+	out->len = end - out->buffer;
+}
+
+/* output_text : add text of any length to an output file
+ * parameters  : out  - a pointer to the output file
+ * 				 text - the text to add
+ * 				 len  - the length of the text
+ * return      :*/
+void output_text(output_file *out, const char *text, const size_t len) {
+	size_t pos,
+		   part;
+
+	for (pos = 0; pos < len; pos += part) {
+		part = len - pos < OUTPUT_BUFFER_SIZE ? len - pos : OUTPUT_BUFFER_SIZE;
+		memcpy(output_reserve(out, part), text + pos, part);
+		out->len += part;
+	}
+}
+
+/* output_capture : start an output that is kept in memory instead of a file, of a
+ * 					size known in advance it is filled in place like a mapped file
+ * parameters     : out   - a pointer to the output file to start
+ * 					bytes - the output for the contents, they are set when it is
+ * 							closed
+ * 					size  - the size of the output or 0 if it isnt known
+ * return         : NO_ERROR           - if the output is ready to be written
+ * 					ERROR_MEMORY_ALLOC - if there was an error allocating the buffer*/
+error_value output_capture(output_file *out, output_bytes *bytes, const size_t size) {
+	output_reset(out);
+	out->memory = bytes;
+	bytes->data = NULL;
+	bytes->size = 0;
+
+	if (!(out->buffer = malloc(size ? size : OUTPUT_BUFFER_SIZE)))
+		return ERROR_MEMORY_ALLOC;
+	out->len = size;
+
+	return NO_ERROR;
+}
+
+/* output_close : write what is left in the buffer of an output file and close it,
+ * 				  a mapped file is unmapped, a file that replaces an existing file is
+ * 				  renamed over it and a file that was the same as the existing file
+ * 				  is left out so the existing file isnt touched, a captured output
+ * 				  is left in its contents even if there was an error
+ * parameters   : out - a pointer to the output file
+ * return       : NO_ERROR           - if the whole file was written
+ * 				  ERROR_CREATE_FILE  - if there was an error writing the file
+ * 				  ERROR_MEMORY_ALLOC - if a captured output couldnt grow*/
+error_value output_close(output_file *out) {
+	/*the pages of a mapped file are written by the system*/
+	if (out->mapped) {
+		if (munmap(out->buffer, out->len))
+			out->err = ERROR_CREATE_FILE;
+		else
+			out->written = out->len;
+	} else {
+		/*an output that fit in its buffer is kept as it is*/
+		if (out->memory && !out->memory->data && !out->err) {
+			if (!(out->memory->data = realloc(out->buffer, out->len ? out->len : 1)))
+				out->memory->data = out->buffer;
+			out->memory->size = out->written = out->len;
+			out->buffer = NULL;
+			out->len = 0;
+		}
+		output_flush(out);
+		free(out->buffer);
+	}
+
+	/*the output is the same as the existing file only if it ends there too*/
+	if (out->old_fd >= 0 && !out->err && read_old(out, 1))
+		stop_comparing(out);
+	if (out->old_fd >= 0)
+		close(out->old_fd);
+	free(out->old_buffer);
+
+	if (out->fd >= 0 && close(out->fd) && !out->err)
+		out->err = ERROR_CREATE_FILE;
+	if (out->temp_name) {
+		if (!out->err && rename(out->temp_name, out->file_name))
+			out->err = ERROR_CREATE_FILE;
+		if (out->err)
+			unlink(out->temp_name);
+		free(out->temp_name);
+	}
+
+	return out->err;
+}
+
+/* format_number : write a number in decimal two digits at a time from the last ones
+ * 				   back, padded on the left to a width like printf does
+ * parameters    : number - the number to write, it is not negative
+ * 				   width  - the least number of characters to write
+ * 				   pad    - the character to pad with, '0' or ' '
+ * 				   out    - the output for the characters, they are not terminated
+ * return        : a pointer to the character after the number*/
+char *format_number(int number, const int width, const char pad, char *out) {
+	char *end,
+		 *pos;
+	int  digits;
+
+	/*padding with zeros is writing more digits*/
+	for (digits = pad == '0' ? width : 1;
+		 digits < MAX_NUMBER_DIGITS && number >= powers_of_ten[digits]; digits++);
+	end = out + (digits > width ? digits : width);
+
+	for (pos = end; digits > 1; digits -= 2, number /= 100) {
+		pos -= 2;
+		memcpy(pos, decimal_pairs + 2 * (number % 100), 2);
+	}
+	if (digits)
+		*--pos = '0' + number;
+	while (pos > out)
+		*--pos = pad;
+
+	return end;
+}
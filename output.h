@@ -0,0 +1,55 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include "defs.h"
+#include "error.h"
+
+/*the size of the buffer an output file is formatted in before it is written*/
+#define OUTPUT_BUFFER_SIZE (256 * 1024)
+
+/* a struct representing the contents of an output file that was captured in memory
+ * data is NULL if nothing was captured, else it is allocated and owned by whoever
+ * captured it*/
+typedef struct{
+	char *data;
+	size_t size;
+} output_bytes;
+
+/* a struct representing an output file that is formatted in memory and written a
+ * full buffer at a time, the first error is kept and reported when it is closed
+ * a file of a size known in advance can be mapped instead and filled in place
+ * written is the number of characters that reached the file so far
+ * a file that is kept when it is unchanged has its name in file_name (else it is
+ * NULL), while the output is the same as the start of the existing file old_fd is
+ * the existing file, compared is how much of it matched and nothing is written,
+ * once they differ the output goes to temp_name that replaces the file when it is
+ * closed, old_mode is the permissions of the existing file or -1 if there is none
+ * an output that is captured instead of written to a file goes to memory*/
+typedef struct{
+	int fd;
+	char *buffer;
+	size_t len;
+	long written;
+	error_value err;
+	int mapped;
+	const char *file_name;
+	char *temp_name;
+	int old_fd;
+	int old_mode;
+	long compared;
+	char *old_buffer;
+	output_bytes *memory;
+} output_file;
+
+extern const char decimal_pairs[];
+
+error_value output_open(output_file*, const char*, const int);
+error_value output_map(output_file*, const char*, const size_t, const int);
+error_value output_capture(output_file*, output_bytes*, const size_t);
+char *output_reserve(output_file*, const size_t);
+void output_commit(output_file*, const char*);
+void output_text(output_file*, const char*, const size_t);
+error_value output_close(output_file*);
+char *format_number(int, const int, const char, char*);
+
+#endif
@@ -16,26 +16,29 @@
 static error_value parse_directive_params(parsed_line *line, symtable *symtable_p) {
 	error_value err_val = NO_ERROR;
 
+	switch (line->keyword->directive) {
 	/*if data directive check if valid parameters*/
-	if (!strcmp(line->name, ".data")) {
-		if (!is_valid_data_params(line->parameters, symtable_p))
+	case DATA_DIRECTIVE:
+		if (!is_valid_data_params(line->line, line->params, line->num_of_params,
+								  symtable_p))
 			err_val = INVALID_PARAMETERS;
-
+		break;
 		/*if string directive check if valid parameters*/
-	} else if (!strcmp(line->name, ".string")) {
+	case STRING_DIRECTIVE:
 		if (!is_valid_string(line->parameters))
 			err_val = INVALID_STRING;
-
+		break;
 		/*if extern directive check if valid parameters*/
-	} else if (!strcmp(line->name, ".extern")) {
+	case EXTERN_DIRECTIVE:
 		if (valid_label(line->parameters, symtable_p))
 			err_val = INVALID_PARAMETERS;
 		else if (find_symbol(line->parameters, symtable_p))
 			err_val = DUPLICATE_LABEL;
-
+		break;
 		/*if entry directive check if valid parameters*/
-	} else
+	default:
 		err_val = valid_label(line->parameters, symtable_p);
+	}
 
 	return err_val;
 }
@@ -50,67 +53,193 @@ static error_value parse_directive_params(parsed_line *line, symtable *symtable_
  * 							   INVALID_PARAMETERS - if the parameters are invalid*/
 static error_value parse_instruction_params(parsed_line *line, symtable *symtable_p) {
 	error_value err_val = NO_ERROR;
-	int 	    len = strlen(line->parameters),
-				num_of_params = get_num_of_params(line);
-	char 		*param,
-			    param_cpy[MAX_LINE_LEN];
-
-	/*make a copy of the sting to work on so we dont alter the original string*/
-	strcpy(param_cpy, line->parameters);
+	int 	    num_of_params = get_num_of_params(line),
+				i,
+				checked;
 
 	/*if there are any parameters*/
-	if (len) {
-		/*check the commas in the parameters string*/
-		if (param_cpy[0] == ',' || param_cpy[len - 1] == ',' || is_adjacent_commas(param_cpy)) {
+	if (line->num_of_params) {
+		/*check the commas in the parameters*/
+		if (!line->params[0].len || !line->params[line->num_of_params - 1].len) {
 			err_val = SYNTAX_ERROR;
 
 			/*check if the number of parameters matches the operation*/
-		} else if (num_of_params != get_op_num_of_params(line->name))
+		} else if (num_of_params != line->keyword->op->num_of_parameters)
 			err_val = INVALID_NUM_OF_PARAMS;
 		else {
-
-			/*check if the first parametes is legal*/
-			param = strtok(param_cpy, PARSING_PARAMS_TOKENS);
-			err_val = is_valid_instruction_param(param, symtable_p) ?
-					NO_ERROR : INVALID_PARAMETERS;
-
-			/*if theres a second parametes check if it is legal*/
-			if (!err_val && num_of_params > 1) {
-				param = strtok(NULL, PARSING_PARAMS_TOKENS);
-				err_val = is_valid_instruction_param(param, symtable_p) ?
-						NO_ERROR : INVALID_PARAMETERS;
-			}
+			/*check if every parameter is legal*/
+			for (i = checked = 0; !err_val && checked < num_of_params; i++)
+				if (line->params[i].len) {
+					err_val = is_valid_instruction_param(line->line + line->params[i].offset,
+														 symtable_p) ? NO_ERROR : INVALID_PARAMETERS;
+					checked++;
+				}
 		}
 
 		/*if no parameters then check if its an operation that doesnt require parameters*/
-	} else if (strcmp(line->name, "stop") && strcmp(line->name, "rts"))
+	} else if (line->keyword->op->num_of_parameters)
 		err_val = INVALID_NUM_OF_PARAMS;
 
 	return err_val;
 }
 
+/* terminate_run : terminate a run of tokens in the line in place
+ * parameters    : line  - a pointer to a parsed line struct
+ * 				   first - the index of the first token of the run
+ * 				   end   - the index of the token after the run
+ * return        : a pointer to the terminated run*/
+static char *terminate_run(parsed_line *line, const int first, const int end) {
+	token *last = &line->tokens.tokens[end - 1];
+
+	line->line[last->offset + last->len] = '\0';
+
+	return line->line + line->tokens.tokens[first].offset;
+}
+
+/* is_define  : check if a run of tokens is the .define keyword
+ * parameters : line  - a pointer to a parsed line struct
+ * 				first - the index of the first token of the run
+ * 				end   - the index of the token after the run
+ * return     : non zero value if the run is .define
+ * 				else return zero*/
+static int is_define(parsed_line *line, const int first, const int end) {
+	token 		  *tokens = line->tokens.tokens;
+	const keyword *kw = find_keyword_n(line->line + tokens[first].offset,
+									   tokens[end - 1].offset + tokens[end - 1].len -
+									   tokens[first].offset);
+
+	return kw && kw->kind == DEFINE_KEYWORD;
+}
+
+/* split_params : split the parameters of the line to comma separated parameters
+ * 				  the words of a parameter are joined and terminated in place
+ * parameters   : line  - a pointer to a parsed line struct
+ * 				  first - the index of the first token of the parameters
+ * return       :*/
+static void split_params(parsed_line *line, const int first) {
+	token *tokens = line->tokens.tokens,
+		  *param;
+	int   num_of_tokens = line->tokens.num_of_tokens,
+		  start,
+		  i;
+
+	/*every comma ends a parameter and so does the end of the line*/
+	for (i = start = first; first < num_of_tokens && i <= num_of_tokens; i++)
+		if (i == num_of_tokens || tokens[i].kind == COMMA_TOKEN) {
+			param = &line->params[line->num_of_params++];
+			param->kind = WORD_TOKEN;
+			param->joined = FALSE;
+			/*a missing parameter points to the terminated comma next to it*/
+			if (i == start) {
+				param->offset = tokens[i < num_of_tokens ? i : i - 1].offset;
+				param->len = 0;
+			} else {
+				param->offset = tokens[start].offset;
+				param->len = join_tokens(line->line, tokens + start, i - start);
+				line->line[param->offset + param->len] = '\0';
+			}
+			if (i < num_of_tokens)
+				line->line[tokens[i].offset] = '\0';
+			start = i + 1;
+		}
+}
+
+/* keep_params : keep the parameters of the line as one string
+ * 				 the string directive keeps its whitespace, the others are joined
+ * parameters  : line  - a pointer to a parsed line struct
+ * 				 first - the index of the first token of the parameters
+ * return      :*/
+static void keep_params(parsed_line *line, const int first) {
+	token *tokens = line->tokens.tokens + first;
+	int   num_of_tokens = line->tokens.num_of_tokens - first;
+
+	if (num_of_tokens) {
+		if (line->keyword->directive == STRING_DIRECTIVE)
+			terminate_run(line, first, line->tokens.num_of_tokens);
+		else
+			line->line[tokens[0].offset +
+					   join_tokens(line->line, tokens, num_of_tokens)] = '\0';
+		line->parameters = line->line + tokens[0].offset;
+	}
+}
+
+/* parse_name : a function to parse the name of a directive or an instruction line
+ * 				the name is classified once and the keyword is kept in the parsed line
+ * parameters : line  - a pointer to a parsed line struct
+ * 				first - the index of the first token of the name
+ * 				end   - the index of the token after the name
+ * return     : NO_ERROR            - if the name parsed succesfully
+ * 				INVALID_DIRECTIVE   - if a directive is invalid
+ * 				INVALID_INSTRUCTION - if an instruction is invalid*/
+static error_value parse_name(parsed_line *line, const int first, const int end) {
+	const char    *token = terminate_run(line, first, end);
+	const keyword *kw = find_keyword(token);
+
+	/*a name that starts with '.' must be a directive else it must be an operation*/
+	if (token[0] == '.') {
+		if (!kw || kw->kind != DIRECTIVE_KEYWORD)
+			return INVALID_DIRECTIVE;
+		line->type = DIRECTIVE_TYPE;
+	} else {
+		if (!kw || kw->kind != OPERATION_KEYWORD)
+			return INVALID_INSTRUCTION;
+		line->type = INSTRUCTION_TYPE;
+	}
+
+	line->name = token;
+	line->keyword = kw;
+
+	return NO_ERROR;
+}
+
+/* single_word : find the only word of a string and terminate it in place
+ * parameters  : text - the string to look in
+ * return      : a pointer to the word or NULL if the string has no word or
+ * 				 more than one*/
+static char *single_word(char *text) {
+	char *end;
+
+	for (; char_is(*text, CHAR_BLANK); text++);
+	for (end = text; *end && !char_is(*end, CHAR_BLANK); end++);
+	if (end == text)
+		return NULL;
+
+	/*only blanks can follow the word*/
+	if (*end) {
+		*end++ = '\0';
+		for (; char_is(*end, CHAR_BLANK); end++);
+	}
+
+	return *end ? NULL : text;
+}
+
 /* parse_macro : a function to parse a macro line
  * parameters  : line       - a pointer to a parsed line struct
- * 				 token      - the current parsing token from strok
+ * 				 pos        - the position in the line right after the .define
  * 				 symtable_p - a pointer to a symbol table
  * return      : NO_ERROR      - if line parsed succesfully
  * 			     NOT_A_NUMBER  - if the macro parameter is no a number
  * 			     INVALID_MACRO - if the macro name is invalid
  * 			     SYNTAX_ERROR  - if theres a syntax error in the line
  * 			     RESERVED_WORD - if the macro is a reserved word*/
-static error_value parse_macro(parsed_line *line, char *token, symtable *symtable_p) {
+static error_value parse_macro(parsed_line *line, const int pos, symtable *symtable_p) {
 	error_value err_val = NO_ERROR;
-	char  *macro_name,
-	      *macro_param;
-
-	/*try to get the rest of the line, find the '=' sign and check if the
-	 * syntax is correct*/
-	if((macro_name = strtok(NULL, "\n\r")) &&
-	   (macro_param = find_eq_sign(macro_name)) &&
-       (macro_name != macro_param && macro_param + 1)){
-		/* if everything if correct then save the name of the macro and the parameter*/
-		macro_param[0] = '\0';
-		macro_param++;
+	char  		*macro_name = line->line + pos,
+				*macro_param,
+				*end;
+
+	/*the rest of the line starts after the whitespace that follows the .define*/
+	if (*macro_name)
+		macro_name++;
+	macro_name += strspn(macro_name, PARSING_END_OF_LINE_TOKENS);
+	end = macro_name + strcspn(macro_name, PARSING_END_OF_LINE_TOKENS);
+
+	/*find the '=' sign and check if the syntax is correct*/
+	if (*macro_name && (macro_param = memchr(macro_name, '=', end - macro_name)) &&
+		macro_name != macro_param) {
+		/* if everything if correct then split the name of the macro and the parameter*/
+		*end = '\0';
+		*macro_param++ = '\0';
 		/*parse the name of the macro and the parameter*/
 		if(!(err_val = parse_macro_name(line, macro_name, symtable_p)))
 			if(!(err_val = parse_macro_param(line, macro_param)))
@@ -125,22 +254,20 @@ static error_value parse_macro(parsed_line *line, char *token, symtable *symtabl
  * parameters        : line - a pointer to a parsed line struct
  * return 	         : the number of parameters*/
 int get_num_of_params(parsed_line *line) {
-	int  param_cnt;
-	char *temp,
-		 line_cpy[MAX_LINE_LEN];
+	int param_cnt,
+		i;
 
-	/*make a copy of the line so we wont alter the original line*/
-	strcpy(line_cpy, line->parameters);
-
-	/*tokenize and count the parameters */
-	for (param_cnt = 0, temp = strtok(line_cpy, ",");
-			temp; temp = strtok(NULL, ","), param_cnt++);
+	/*a missing parameter between commas is not counted*/
+	for (param_cnt = i = 0; i < line->num_of_params; i++)
+		if (line->params[i].len)
+			param_cnt++;
 
 	return param_cnt;
 }
 
 /* parse_line : parse a raw line from the file into a struct containig a label, a
  * 			   name of operation, directive or macro and the parameters
+ * 			   the line must already be pre-scanned with scan_line
  * parameters : line       - a pointer to a parsed line struct
  * 			    symtable_p - a pointer to a symbol table
  * return     : NO_ERROR              - if the line parsed succesfully
@@ -162,96 +289,69 @@ int get_num_of_params(parsed_line *line) {
  *              */
 error_value parse_line(parsed_line *line, symtable *symtable_p) {
 	error_value err_val = NO_ERROR;
-	int         token_num;
-	char        *token;
-
-	/*tokenize the line and parse each token*/
-	for (token_num = 1, token = strtok(line->line, PARSING_WHITESPACE_TOKENS);
-		 token && !err_val;
-		 token = strtok(NULL, PARSING_WHITESPACE_TOKENS), token_num++) {
-
-		/*parse each token by its location
-		 * first token can be only label, define, a directive or an instruction
-		 * second token can be only in instruction, a directive or parameters
-		 * third token can be only parameters*/
-		switch (token_num) {
-		case 1:
-			/*check if first token is label*/
-			if (token[strlen(token) - 1] == ':') {
-				/*if it is then remove the ':' at the end*/
-				token[strlen(token) - 1] = '\0';
-				/*check if the label is valid*/
-				if (!(err_val = valid_label(token, symtable_p))) {
-					/*if it is then check if its already previously declared*/
-					if (!find_symbol(token, symtable_p))
-						/*if not then add it to the parsed line struct*/
-						strcpy(line->label, token);
-					/*if yes then throw an error*/
-					else
-						err_val = DUPLICATE_LABEL;
-				}
-				/*check if first token is macro*/
-			} else if (!strcmp(token, ".define"))
-				/*if yes then parse it*/
-				err_val = parse_macro(line, token, symtable_p);
-			/*check if the first token is a directive*/
-			else if (token[0] == '.') {
-				/*if yes the parse it*/
-				if (!(err_val = valid_directive(token))) {
-					strcpy(line->name, token);
-					line->type = DIRECTIVE_TYPE;
-				}
-				/*check if first token is an instruction*/
-			} else if (!(err_val = valid_instruction(token))) {
-				/*if yes then parse it*/
-				strcpy(line->name, token);
-				line->type = INSTRUCTION_TYPE;
+	token_list  *list = &line->tokens;
+	token       *last;
+	int         first = 0,
+				end = 0;
+	char 		*label;
+
+	/*split the line to tokens once, the parser only looks at their spans*/
+	lex_line(line->line, &line->scan, list);
+
+	/*the first run of tokens without whitespace between them can be only a label,
+	 * a define, a directive or an instruction*/
+	if (list->num_of_tokens) {
+		end = run_end(list, first);
+		last = &list->tokens[end - 1];
+		/*check if first run is label, it cant be if there is no ':' in it*/
+		if (line->scan.colon >= 0 && line->scan.colon < last->offset + last->len &&
+			line->line[last->offset + last->len - 1] == ':') {
+			/*if it is then remove the ':' at the end*/
+			line->line[last->offset + last->len - 1] = '\0';
+			label = line->line + list->tokens[first].offset;
+			/*check if the label is valid*/
+			if (!(err_val = valid_label(label, symtable_p))) {
+				/*if it is then check if its already previously declared*/
+				if (!find_symbol(label, symtable_p))
+					/*if not then add it to the parsed line struct*/
+					line->label = label;
+				/*if yes then throw an error*/
+				else
+					err_val = DUPLICATE_LABEL;
 			}
-			break;
-		case 2:
-			/*check if first token was a label*/
-			if (line->type == UNDEF_TYPE) {
-				/*if yes then check if the second token in is a macro*/
-				if (strcmp(token, ".define")){
-					/*if not the check if second token is a directive*/
-					if (token[0] == '.') {
-						/*if yes then parse it*/
-						if (!(err_val = valid_directive(token))) {
-							strcpy(line->name, token);
-							line->type = DIRECTIVE_TYPE;
-						}
-						/*if not then the second token must be an instruction*/
-					} else if (!(err_val = valid_instruction(token))) {
-						strcpy(line->name, token);
-						line->type = INSTRUCTION_TYPE;
-					}
-					/*if its is a macro the throw an error because macro and label cant
-					 * be defined in same line*/
-				}else
-					err_val = MACRO_AFTER_LABEL;
-				/*if the first token wasnt a label then the second token can be only a parameter*/
-			} else
-				strcat(line->parameters, token);
-			break;
-			/*every token after the second must be a parameter so add it to the parameters
-			 * of the parsed line struct*/
-		default:
-			strcat(line->parameters, token);
-			break;
-		}
+
+			/*if there was only a label then throw an empty label error*/
+			if (!err_val && end == list->num_of_tokens)
+				err_val = EMPTY_LABEL;
+			/*the second run can be only a directive or an instruction, a macro
+			 * and a label cant be defined in same line*/
+			else if (!err_val) {
+				first = end;
+				end = run_end(list, first);
+				err_val = is_define(line, first, end) ? MACRO_AFTER_LABEL :
+						  parse_name(line, first, end);
+			}
+			/*check if first run is macro, it takes the rest of the line*/
+		} else if (is_define(line, first, end))
+			return parse_macro(line, last->offset + last->len, symtable_p);
+		/*if not then it is a directive or an instruction*/
+		else
+			err_val = parse_name(line, first, end);
 	}
 
-	/*if there wasnt an error in parsig the line then parse the parameters*/
-	if(!err_val){
-		/*if there was only a label then throw an empty label error*/
-		if(token_num == 2 && line->type == UNDEF_TYPE)
-			err_val = EMPTY_LABEL;
-		else{
-			/*parse the parameters of the line*/
-			if (line->type == DIRECTIVE_TYPE)
-				err_val = parse_directive_params(line, symtable_p);
-			if (line->type == INSTRUCTION_TYPE)
-				err_val = parse_instruction_params(line, symtable_p);
+	/*if there wasnt an error in parsig the line then parse the parameters, every
+	 * run after the name is a parameter*/
+	if (!err_val) {
+		if (line->type == DIRECTIVE_TYPE) {
+			if (line->keyword->directive == DATA_DIRECTIVE)
+				split_params(line, end);
+			else
+				keep_params(line, end);
+			err_val = parse_directive_params(line, symtable_p);
+		}
+		if (line->type == INSTRUCTION_TYPE) {
+			split_params(line, end);
+			err_val = parse_instruction_params(line, symtable_p);
 		}
 	}
 
@@ -263,11 +363,12 @@ error_value parse_line(parsed_line *line, symtable *symtable_p) {
  * return            :
  */
 void reset_parsed_line(parsed_line *line) {
-	strcpy(line->label, "");
-	strcpy(line->name, "");
-	strcpy(line->line, "");
-	strcpy(line->parameters, "");
+	line->line[0] = '\0';
+	line->tokens.num_of_tokens = 0;
+	line->label = line->name = line->parameters = "";
+	line->num_of_params = 0;
 	line->type = UNDEF_TYPE;
+	line->keyword = NULL;
 	line->macro_value = 0;
 }
 
@@ -283,21 +384,14 @@ void reset_parsed_line(parsed_line *line) {
 error_value parse_macro_name(parsed_line *line, char *macro_name, symtable *symtable_p){
 	error_value err_val = NO_ERROR;
 
-	/*remove white space at teh begginning of the string*/
-	if(isspace(macro_name[0]))
-		macro_name = strtok(macro_name, PARSING_WHITESPACE_TOKENS);
-
-	/*remove white space at the end*/
-	macro_name = strtok(macro_name, PARSING_WHITESPACE_TOKENS);
-
-	/*check if there still a string to parse and if its the only macro name in the string*/
-	if(macro_name && !strtok(NULL, PARSING_WHITESPACE_TOKENS)){
+	/*check if there is a name and if its the only macro name in the string*/
+	if((macro_name = single_word(macro_name))){
 		/*check if the name of the macro is valid*/
 		if(!(err_val = valid_macro_name(macro_name, symtable_p))){
 			/*check if the name is a reserved word*/
 			if(!is_reserved_word(macro_name))
 				/*add it to the parsed line struct*/
-				strcpy(line->name, macro_name);
+				line->name = macro_name;
 			else
 				err_val = RESERVED_WORD;
 		}
@@ -316,12 +410,8 @@ error_value parse_macro_name(parsed_line *line, char *macro_name, symtable *symt
 error_value parse_macro_param(parsed_line *line, char *macro_param){
 	error_value err_val = NO_ERROR;
 
-	/*remove white space at the begginning*/
-	if(isspace(macro_param[0]))
-		macro_param = strtok(macro_param, PARSING_WHITESPACE_TOKENS);
-
-	/*check if only one parameter is in teh string*/
-	if(macro_param && !strtok(NULL, PARSING_WHITESPACE_TOKENS))
+	/*check if only one parameter is in the string*/
+	if((macro_param = single_word(macro_param)))
 		/*check if its a legal number */
 		if(is_legal_number(macro_param))
 			/*if yes then add it to the parsed line struct*/
@@ -332,5 +422,4 @@ error_value parse_macro_param(parsed_line *line, char *macro_param){
 		err_val = SYNTAX_ERROR;
 
 	return err_val;
-
 }
@@ -4,6 +4,8 @@
 #include "defs.h"
 #include "error.h"
 #include "symtable.h"
+#include "keyword.h"
+#include "lexer.h"
 
 /*enum of types of lines*/
 typedef enum{
@@ -13,14 +15,25 @@ typedef enum{
 	UNDEF_TYPE
 }line_type;
 
-/*a struct representing a parsed line*/
+/* a struct representing a parsed line
+ * scan is the pre-scan of the line that the tokens are found from
+ * label, name and parameters point into line where the parser terminated them
+ * keyword is the operation or the directive the name of the line was classified as
+ * params are the comma separated parameters of an instruction or a data directive,
+ * a parameter with no length stands for a missing parameter next to a comma
+ * the parameters of the other directives are kept whole in parameters*/
 typedef struct{
-	char line[MAX_LINE_LEN + 1];
-	char label[MAX_LABEL_LEN + 1];
-	char name[MAX_LABEL_LEN + 1];
+	char line[SCAN_LINE_SIZE];
+	line_scan scan;
+	token_list tokens;
+	const char *label;
+	const char *name;
+	const keyword *keyword;
 	int macro_value;
 	line_type type;
-	char parameters[MAX_LINE_LEN + 1];
+	const char *parameters;
+	token params[MAX_TOKENS];
+	int num_of_params;
 }parsed_line;
 
 int get_num_of_params(parsed_line*);
@@ -7,38 +7,85 @@
  *parameters             : line       - a pointer to a parsed line struct
  *                         symtable_p - a pointer to a symbol_table
  *                         mem_img    - a pointer to a memory image
+ *                         line_num   - the number of the line in the file
  *return                 : NO_ERROR              - if no error occured
  *                         ERROR_MEMORY_ALLOC    - if encountered a memory allocation error
  *                         MACRO_PARAM_UNDEFINED - if an undefined macro parameter is passed*/
 static error_value pass1_handle_directive(parsed_line *line, symtable *symtable_p,
-										  memory_image *mem_img) {
-	error_value err_val;
+										  memory_image *mem_img, const int line_num) {
+	error_value  err_val = NO_ERROR;
+	directive_id directive = line->keyword->directive;
 
 	/*if there is a label add it to the symbol table
 	 * expect and entry line to extern then igone the label*/
-	if (strlen(line->label) && strcmp(line->name, ".entry")
-							&& strcmp(line->name, ".extern"))
+	if (strlen(line->label) && directive != ENTRY_DIRECTIVE
+							&& directive != EXTERN_DIRECTIVE)
 		err_val = add_symbol(symtable_p, line->label, mem_img->data->dc, DATA);
 	/*if label succesfully added*/
 	if (!err_val) {
+		switch (directive) {
 		/*if its a string directive then try to add the string to the data table*/
-		if (!strcmp(line->name, ".string"))
+		case STRING_DIRECTIVE:
 			err_val = add_string_data(mem_img->data, line->parameters);
-		/*if its a data directive the try to add the numbers to the data table*/
-		else if (!strcmp(line->name, ".data"))
-			err_val = add_num_data(mem_img->data, line->parameters, symtable_p);
-		/*if its and extern directive then try to add it to the symbol table*/
-		else if (!strcmp(line->name, ".extern"))
+			break;
+			/*if its a data directive the try to add the numbers to the data table*/
+		case DATA_DIRECTIVE:
+			err_val = add_num_data(mem_img->data, line->line, line->params,
+								   line->num_of_params, symtable_p);
+			break;
+			/*if its and extern directive then try to add it to the symbol table*/
+		case EXTERN_DIRECTIVE:
 			err_val = add_symbol(symtable_p, line->parameters, 0, EXTERNAL);
+			break;
+			/* if its an entry directive the symbol may not be defined yet so keep it
+			 * to be flagged after the first pass*/
+		case ENTRY_DIRECTIVE:
+			err_val = add_entry_decl(mem_img->ir, line->parameters, line_num);
+			break;
+		default:
+			break;
+		}
 	}
 
 	return err_val;
 }
 
+/* check_addr_mode : a function to check if an addressing mode of a parameter is allowed
+ * 					 by the operation
+ * parameters      : op_params       - the number of parameters of the operation
+ * 					 num_of_param    - the index of the parameter in the line
+ * 					 mode            - the addressing mode of the parameter
+ * 					 allowed_op_src  - the source addressing modes the operation allows
+ * 					 allowed_op_dest - the destination addressing modes the operation allows
+ * return          : NO_ERROR               - if the addressing mode is allowed
+ * 					 INVALID_ADDR_DEST_MODE - if the parameters destination addressing
+ * 							                  mode is not allowed by the operation
+ * 					 INVALID_ADDR_SRC_MODE  - if the parameters source addressing
+ * 							  			      mode is not allowed by the operation*/
+static error_value check_addr_mode(const int op_params, const int num_of_param,
+								   const int mode, const int allowed_op_src,
+								   const int allowed_op_dest) {
+	error_value err_val = NO_ERROR;
+
+	/* the only parameter of an operation is its destination
+	 * the first of two parameters is the source, if the source doesnt allow it
+	 * the destination check decides which error is reported*/
+	if (op_params == 2 && num_of_param == 0) {
+		if (allowed_op_src & mode)
+			return NO_ERROR;
+		err_val = INVALID_ADDR_SRC_MODE;
+	}
+
+	return allowed_op_dest & mode ? err_val : INVALID_ADDR_DEST_MODE;
+}
+
 /* pass1_handle_instruction : a funtion to handle an instruction line
+ * 							  every parameter is decoded once to the ir table and
+ * 							  encoded from there
  * parameters               : line       - a pointer to a parsed line struct
  * 							  symtable_p - a pointer to a symbol table
  * 							  mem_img    - a pointer to a memory image
+ * 							  line_num   - the number of the line in the file
  * return			        : NO_ERROR               - if no error occured
  * 							  ERROR_MEMORY_ALLOC     - if a memory allocation error occured
  * 							  INVALID_ADDR_DEST_MODE - if the parameters source addressing
@@ -46,16 +93,13 @@ static error_value pass1_handle_directive(parsed_line *line, symtable *symtable_
  * 							  INVALID_ADDR_SRC_MODE  - if the parametersdestination addressing
  * 							  					       mode is not allowed by the operation*/
 static error_value pass1_handle_instruction(parsed_line *line, symtable *symtable_p,
-											memory_image *mem_img) {
-	error_value     err_val = NO_ERROR;
-	int			    word = 0,
-					i,
-					op_params = get_op_num_of_params(line->name),
-					allowed_op_src = get_op_allowed_src(line->name),
-					allowed_op_dest = get_op_allowed_dest(line->name),
-					op_value = get_op_value(line->name),
-					addr_mode[2];
-	char 			*param;
+											memory_image *mem_img, const int line_num) {
+	error_value         err_val = NO_ERROR;
+	const op_entry      *op = line->keyword->op;
+	int			        i,
+						j;
+	decoded_instruction inst,
+						*inst_p;
 
 	/*if the line has a label try to add it to the symbol table with the value
 	 * of the current ic + the address offset we assume the program start from*/
@@ -64,58 +108,31 @@ static error_value pass1_handle_instruction(parsed_line *line, symtable *symtabl
 				  mem_img->code->ic + ADDRESS_OFFSET, CODE);
 	/*if label succesfully added*/
 	if (!err_val) {
-		/*encode the operation in the memory word*/
-		word = word | encode_op(op_value);
-		/*get the first parameter of the line if any*/
-		param = strtok(line->parameters, PARSING_PARAMS_TOKENS);
-
-		/*itterate over the parameters of the line and encode the first memory word
-		 * by their addressing modes*/
-		for (i = 0; !err_val && param && i < op_params;
-			 i++, param = strtok(NULL, PARSING_PARAMS_TOKENS)) {
-			addr_mode[i] = get_addr_mode(param, symtable_p);
-
-			/*if the operation requires one parameter*/
-			if (op_params == 1) {
-				/*encode the only parameter*/
-				if (i == 0 && !(err_val = allowed_op_dest & addr_mode[i] ?
-										  err_val : INVALID_ADDR_DEST_MODE))
-					word = word | encode_dest_mode(get_addr_mode_val(addr_mode[i]));
-			} else {
-				/*if the operation requires two parameters
-				 * encode both to their appropriate location in the memory word*/
-				if (i == 0 && !(err_val = allowed_op_src & addr_mode[i] ?
-									      err_val : INVALID_ADDR_SRC_MODE))
-					word = word | encode_src_mode(get_addr_mode_val(addr_mode[i]));
-				else if (!(err_val = allowed_op_dest & addr_mode[i] ?
-									 err_val : INVALID_ADDR_DEST_MODE))
-					word = word | encode_dest_mode(get_addr_mode_val(addr_mode[i]));
-			}
-			/*if the operation reqires no parameters we wont itterate and wont encode the parameters*/
+		inst.op = op->value;
+		inst.num_of_operands = op->num_of_parameters;
+		inst.line = line_num;
+		/*itterate over the parameters of the line, decode them and check their
+		 * addressing modes, a missing parameter between commas is skipped*/
+		for (i = j = 0; !err_val && j < line->num_of_params && i < inst.num_of_operands;
+			 j++) {
+			if (!line->params[j].len)
+				continue;
+			if (!(err_val = decode_operand(line->line + line->params[j].offset, symtable_p,
+										   mem_img->ir, &inst.operands[i])))
+				err_val = check_addr_mode(inst.num_of_operands, i,
+										  inst.operands[i].mode, op->allowed_src_mode,
+										  op->allowed_dest_mode);
+			i++;
 		}
 
-		/*if encoding the first word was succesfull then reserve word in the code table
-		 * for the parameters to encode in the second pass*/
+		/* if the line was decoded succesfully then keep it and encode it, words that
+		 * refer to symbols that are not final yet are completed after the first pass*/
 		if (!err_val) {
-			/*add the first word to the code table*/
-			add_code(mem_img->code, word);
-			for (i = 0; i < op_params; i++) {
-				/*if the addresing mode is INDEX then reserve two word for each parametes
-				 * one for the name of the label and the second for the index*/
-				if (addr_mode[i] == INDEX) {
-					add_code(mem_img->code, 0);
-					add_code(mem_img->code, 0);
-					/*for every other addresing mode reserve one word for every parameter*/
-				} else {
-					add_code(mem_img->code, 0);
-					/*except if both parameres are REGISTER addressing mode then reserve
-					 * one word for both*/
-					if (i == 0 && addr_mode[i] == REGISTER
-							   && addr_mode[i + 1] == REGISTER)
-						break;
-				}
-
-			}
+			if ((inst_p = add_instruction(mem_img->ir))) {
+				*inst_p = inst;
+				err_val = encode_instruction(inst_p, symtable_p, mem_img);
+			} else
+				err_val = ERROR_MEMORY_ALLOC;
 		}
 	}
 
@@ -126,6 +143,7 @@ static error_value pass1_handle_instruction(parsed_line *line, symtable *symtabl
  * parameter         : line       - a pointer to a parsed line struct
  * 				       symtable_p - a pointer to a symbol table
  * 				       mem_img    - a pointer to a memory image
+ * 				       line_num   - the number of the line in the file
  * return            : NO_ERROR               - if no error occured
  * 				       LINE_TOO_LONG          - if the line is too long
  * 				       INVAlID_LABEL          - if the label is invalid
@@ -149,13 +167,13 @@ static error_value pass1_handle_instruction(parsed_line *line, symtable *symtabl
  * 					   INVALID_ADDR_SRC_MODE  - if the parametersdestination addressing
  * 							  				   mode is not allowed by the operation*/
 static error_value pass1_handle_line(parsed_line *line, symtable *symtable_p,
-							  memory_image *mem_img) {
+							  memory_image *mem_img, const int line_num) {
 	error_value err_val = NO_ERROR;
 
 	/*check if the line is valid*/
-	if (!(err_val = line_valid(line->line)))
+	if (!(err_val = line_valid(line->line, &line->scan)))
 		/*if yes then check if its an empty line or a comment line*/
-		if (!is_empty_line(line->line) && !is_comment_line(line->line))
+		if (!is_empty_line(&line->scan) && !is_comment_line(&line->scan))
 			/*if no then parse the line*/
 			if (!(err_val = parse_line(line, symtable_p)))
 				/*handle each line by its type*/
@@ -167,13 +185,14 @@ static error_value pass1_handle_line(parsed_line *line, symtable *symtable_p,
 					break;
 					/*if its a directive line then encode it and add the data to the data table*/
 				case DIRECTIVE_TYPE:
-					err_val = pass1_handle_directive(line, symtable_p, mem_img);
+					err_val = pass1_handle_directive(line, symtable_p, mem_img,
+													 line_num);
 					break;
 					/*if its an instruction line then encode the first word and reserve
 					 * words for the second pass in the code table*/
 				case INSTRUCTION_TYPE:
 					err_val = pass1_handle_instruction(line, symtable_p,
-													   mem_img);
+													   mem_img, line_num);
 					break;
 				default:
 					err_val = SYNTAX_ERROR;
@@ -183,34 +202,39 @@ static error_value pass1_handle_line(parsed_line *line, symtable *symtable_p,
 }
 
 /* pass1_execute : a function that executes the first pass
- * parameters    : fp         - a pointer to a file
- * 				   mem_img_p  - a pointer to a memory image
- * 				   symtable_p - a pointer to a symbol table
+ * parameters    : source     - a pointer to the source file
+ * 				   context    - a pointer to the assembly context of the file
  * 				   file_name  - the name of the file currently proccesed
  * return        : NO_ERROR    - if no error occured
  * 				   ERROR_PASS1 - if there was an error in the first pass*/
-error_value pass1_execute(FILE *fp, memory_image *mem_img_p,
-						  symtable *symtable_p, const char *file_name) {
+error_value pass1_execute(source_file *source, assembly_context *context,
+						  const char *file_name) {
 	error_value err_val = NO_ERROR;
 	int 		err_flag = FALSE,
 				line_cnt;
-	parsed_line *line;
-
-	/*allocate a parsed lin struct*/
-	if((line = malloc(sizeof(parsed_line)))){
-		/*itterate every line of the file and parse it*/
-		for (line_cnt = 1, reset_parsed_line(line);
-			 fgets(line->line, MAX_LINE_LEN + 2, fp);
-			 line_cnt++, reset_parsed_line(line)) {
-			/*execute first pass of the line*/
-			if ((err_val = pass1_handle_line(line, symtable_p, mem_img_p))) {
-				err_flag = TRUE;
-				print_error(err_val, file_name, line_cnt);
-			}
+	parsed_line *line = context->line;
+	line_slice  slice;
+
+	/*itterate every line of the file and parse it, the parser works on its own
+	 * copy of the line since it terminates the tokens in place*/
+	for (line_cnt = 1, reset_parsed_line(line);
+		 source_next_line(source, &slice);
+		 line_cnt++, reset_parsed_line(line)) {
+		memcpy(line->line, slice.text, slice.len);
+		line->line[slice.len] = '\0';
+		/*pre-scan the line once, the checks and the parser use what it found*/
+		scan_line(line->line, slice.len, &line->scan);
+
+		/*execute first pass of the line*/
+		if ((err_val = pass1_handle_line(line, context->symtable, context->mem_img,
+										 line_cnt))) {
+			err_flag = TRUE;
+			report_error(context->diag, err_val, file_name, line_cnt);
 		}
-		free(line);
-	} else
-		print_error(err_val = ERROR_MEMORY_ALLOC, file_name, 0);
+		/*the type of an empty, a comment or an invalid line is undefined*/
+		if (context->stats)
+			context->stats->lines[line->type]++;
+	}
 
 	return err_flag ? ERROR_PASS1 : NO_ERROR;
 }
@@ -2,9 +2,9 @@
 #define PASS1_H
 
 #include "error.h"
-#include "memory_image.h"
-#include "symtable.h"
+#include "context.h"
+#include "source.h"
 
-error_value pass1_execute(FILE*, memory_image*, symtable*, const char*);
+error_value pass1_execute(source_file*, assembly_context*, const char*);
 
 #endif
@@ -2,10 +2,9 @@
 #define PASS2_H
 
 #include "error.h"
-#include "memory_image.h"
-#include "symtable.h"
+#include "context.h"
 
-error_value pass2_execute(FILE*, memory_image*, symtable*, const char*);
-void pass2_prep(FILE*, memory_image*, symtable*);
+error_value pass2_execute(assembly_context*, const char*);
+void pass2_prep(assembly_context*);
 
 #endif
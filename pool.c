@@ -0,0 +1,221 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include "pool.h"
+
+/* a struct representing the queue of jobs of a worker
+ * the owner takes jobs from the head and the other workers steal from the tail*/
+typedef struct{
+	file_job **jobs;
+	int head;
+	int tail;
+	pthread_mutex_t lock;
+} work_queue;
+
+/*a struct representing the jobs and the queues the workers share*/
+typedef struct{
+	file_job *jobs;
+	int *done;
+	int num_of_workers;
+	work_queue *queues;
+	pthread_mutex_t done_lock;
+	pthread_cond_t done_cond;
+} job_pool;
+
+/*a struct representing a worker thread*/
+typedef struct{
+	job_pool *pool;
+	int id;
+} worker;
+
+/* compare_jobs : compare two jobs so the bigger file comes first, files of the same
+ * 				  size stay in the order they were given
+ * parameters   : a - a pointer to a pointer to the first job
+ * 				  b - a pointer to a pointer to the second job
+ * return       : a negative value if the first job comes first else a positive value*/
+static int compare_jobs(const void *a, const void *b) {
+	const file_job *job_a = *(file_job * const *)a,
+				   *job_b = *(file_job * const *)b;
+
+	if (job_a->size != job_b->size)
+		return job_a->size > job_b->size ? -1 : 1;
+
+	return job_a < job_b ? -1 : 1;
+}
+
+/* take_job   : take the next job of a worker from its own queue or if it is empty
+ * 				steal one from the queue of another worker
+ * parameters : pool - a pointer to the job pool
+ * 				id   - the id of the worker
+ * return     : a pointer to the job or NULL if no jobs are left*/
+static file_job *take_job(job_pool *pool, const int id) {
+	file_job   *job = NULL;
+	work_queue *queue;
+	int 	   i;
+
+	/*take the biggest job left in the queue of the worker*/
+	queue = &pool->queues[id];
+	pthread_mutex_lock(&queue->lock);
+	if (queue->head < queue->tail)
+		job = queue->jobs[queue->head++];
+	pthread_mutex_unlock(&queue->lock);
+
+	/*if the queue is empty steal the smallest job of the next worker that has one*/
+	for (i = 1; !job && i < pool->num_of_workers; i++) {
+		queue = &pool->queues[(id + i) % pool->num_of_workers];
+		pthread_mutex_lock(&queue->lock);
+		if (queue->head < queue->tail)
+			job = queue->jobs[--queue->tail];
+		pthread_mutex_unlock(&queue->lock);
+	}
+
+	return job;
+}
+
+/* worker_run : the function of a worker thread, assemble jobs with an assembly
+ * 				context of its own until no jobs are left
+ * parameters : arg - a pointer to the worker
+ * return     : NULL*/
+static void *worker_run(void *arg) {
+	worker 			 *self = arg;
+	job_pool 		 *pool = self->pool;
+	assembly_context *context = context_init();
+	file_job 		 *job;
+
+	while ((job = take_job(pool, self->id))) {
+		/*without a context the file cant be assembled*/
+		job->worker = self->id + 1;
+		if (context)
+			assemble_file(context, job);
+		else
+			job->err_val = ERROR_MEMORY_ALLOC;
+
+		/*let the main thread know the job can be reported*/
+		pthread_mutex_lock(&pool->done_lock);
+		pool->done[job - pool->jobs] = TRUE;
+		pthread_cond_broadcast(&pool->done_cond);
+		pthread_mutex_unlock(&pool->done_lock);
+	}
+
+	context_free(context);
+
+	return NULL;
+}
+
+/* fill_queues : sort the jobs by the sizes of their files and deal them to the
+ * 				 queues of the workers so every worker starts with the biggest files
+ * parameters  : pool        - a pointer to the job pool
+ * 				 order       - an array to hold a pointer to every job
+ * 				 slots       - an array to hold the queues
+ * 				 num_of_jobs - the number of jobs
+ * return      :*/
+static void fill_queues(job_pool *pool, file_job **order, file_job **slots,
+						const int num_of_jobs) {
+	struct stat info;
+	int 		i,
+				offset;
+
+	/*the size of a file is the estimate of the work to assemble it*/
+	for (i = 0; i < num_of_jobs; i++) {
+		if (!stat(pool->jobs[i].file_name, &info))
+			pool->jobs[i].size = info.st_size;
+		order[i] = &pool->jobs[i];
+	}
+	qsort(order, num_of_jobs, sizeof(file_job*), compare_jobs);
+
+	/*every queue gets a part of the array and the jobs are dealt in turns*/
+	for (i = 0, offset = 0; i < pool->num_of_workers; i++) {
+		pool->queues[i].jobs = slots + offset;
+		pool->queues[i].head = pool->queues[i].tail = 0;
+		offset += (num_of_jobs - i + pool->num_of_workers - 1) / pool->num_of_workers;
+	}
+	for (i = 0; i < num_of_jobs; i++) {
+		pool->queues[i % pool->num_of_workers].jobs
+			[pool->queues[i % pool->num_of_workers].tail++] = order[i];
+	}
+}
+
+/* run_pool   : assemble files in parallel with a pool of worker threads and report
+ * 				every file in the order the files were given once it is done
+ * parameters : jobs           - the jobs of the files
+ * 				num_of_jobs    - the number of jobs
+ * 				num_of_workers - the number of worker threads
+ * return     : NO_ERROR           - if all the jobs were assembled and reported
+ * 				ERROR_MEMORY_ALLOC - if the pool couldnt be allocated, no job was started*/
+error_value run_pool(file_job *jobs, const int num_of_jobs, int num_of_workers) {
+	job_pool  pool;
+	worker    *workers;
+	pthread_t *threads;
+	file_job  **order,
+			  **slots;
+	int 	  i,
+			  started;
+
+	/*there is no use for more workers than jobs*/
+	if (num_of_workers > num_of_jobs)
+		num_of_workers = num_of_jobs;
+
+	pool.jobs = jobs;
+	pool.num_of_workers = num_of_workers;
+	pool.done = calloc(num_of_jobs, sizeof(int));
+	pool.queues = malloc(num_of_workers * sizeof(work_queue));
+	workers = malloc(num_of_workers * sizeof(worker));
+	threads = malloc(num_of_workers * sizeof(pthread_t));
+	order = malloc(num_of_jobs * sizeof(file_job*));
+	slots = malloc(num_of_jobs * sizeof(file_job*));
+
+	if (!pool.done || !pool.queues || !workers || !threads || !order || !slots) {
+		free(pool.done);
+		free(pool.queues);
+		free(workers);
+		free(threads);
+		free(order);
+		free(slots);
+		return ERROR_MEMORY_ALLOC;
+	}
+
+	fill_queues(&pool, order, slots, num_of_jobs);
+	pthread_mutex_init(&pool.done_lock, NULL);
+	pthread_cond_init(&pool.done_cond, NULL);
+	for (i = 0; i < num_of_workers; i++)
+		pthread_mutex_init(&pool.queues[i].lock, NULL);
+
+	/*start the workers, the jobs of a worker that couldnt start are stolen by the others*/
+	for (i = 0, started = 0; i < num_of_workers; i++) {
+		workers[i].pool = &pool;
+		workers[i].id = i;
+		if (!pthread_create(&threads[started], NULL, worker_run, &workers[i]))
+			started++;
+	}
+	/*if no worker could start then do all the work here*/
+	if (!started)
+		worker_run(&workers[0]);
+
+	/*report every file in the order they were given as soon as it is done*/
+	for (i = 0; i < num_of_jobs; i++) {
+		pthread_mutex_lock(&pool.done_lock);
+		while (!pool.done[i])
+			pthread_cond_wait(&pool.done_cond, &pool.done_lock);
+		pthread_mutex_unlock(&pool.done_lock);
+
+		file_job_report(&jobs[i]);
+	}
+
+	for (i = 0; i < started; i++)
+		pthread_join(threads[i], NULL);
+
+	for (i = 0; i < num_of_workers; i++)
+		pthread_mutex_destroy(&pool.queues[i].lock);
+	pthread_cond_destroy(&pool.done_cond);
+	pthread_mutex_destroy(&pool.done_lock);
+	free(pool.done);
+	free(pool.queues);
+	free(workers);
+	free(threads);
+	free(order);
+	free(slots);
+
+	return NO_ERROR;
+}
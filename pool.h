@@ -0,0 +1,9 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "error.h"
+#include "job.h"
+
+error_value run_pool(file_job*, const int, int);
+
+#endif
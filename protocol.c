@@ -0,0 +1,378 @@
+/*SO_PEERCRED and struct ucred are extensions of linux*/
+#define _GNU_SOURCE
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include "protocol.h"
+
+/*the longest first line of a request or a reply, the sizes that follow it*/
+#define MAX_HEADER_LEN 96
+/*the most clients that wait to be accepted*/
+#define LISTEN_BACKLOG 64
+/*the permissions of the socket and of its private directory, only for the user*/
+#define SOCKET_MODE 0600
+#define PRIVATE_DIR_MODE 0700
+/*the room the user id takes in the name of the private directory*/
+#define MAX_UID_LEN 24
+
+/* The requests and the replies are a line of numbers and the bytes they count
+ * request : "<kind> <name length> <data length>\n" <name> <data>
+ * reply   : "<result> <errors length> <.ob> <.ext> <.ent>\n" <errors> <files...>
+ * the length of an output file is -1 if the source doesnt have it*/
+
+/* socket_address : make the address of a socket from its path
+ * parameters     : addr - the output for the address
+ * 					path - the path of the socket
+ * return         : TRUE if the path fits in the address else FALSE*/
+static int socket_address(struct sockaddr_un *addr, const char *path) {
+	if (strlen(path) >= sizeof(addr->sun_path))
+		return FALSE;
+
+	memset(addr, 0, sizeof(struct sockaddr_un));
+	addr->sun_family = AF_UNIX;
+	strcpy(addr->sun_path, path);
+
+	return TRUE;
+}
+
+/* default_socket_path : make the path of the socket in the runtime directory of the
+ * 						 user, or in a directory of its own in /tmp if it has none
+ * 						 since any user can write to /tmp
+ * parameters          : path     - the output for the allocated path
+ * 						 make_dir - TRUE to make the directory in /tmp if it is missing
+ * return              : NO_ERROR           - if the path was made
+ * 						 ERROR_LISTEN       - if the directory in /tmp belongs to another
+ * 											  user or others may use it
+ * 						 ERROR_MEMORY_ALLOC - if the path couldnt be allocated*/
+error_value default_socket_path(char **path, const int make_dir) {
+	const char 	*dir = getenv("XDG_RUNTIME_DIR");
+	struct stat info;
+	int 		trusted;
+
+	if (dir && dir[0]) {
+		if (!(*path = malloc(strlen(dir) + strlen(DEFAULT_SOCKET_NAME) + 2)))
+			return ERROR_MEMORY_ALLOC;
+		sprintf(*path, "%s/%s", dir, DEFAULT_SOCKET_NAME);
+		return NO_ERROR;
+	}
+
+	if (!(*path = malloc(strlen(PRIVATE_SOCKET_DIR) + MAX_UID_LEN +
+						 strlen(DEFAULT_SOCKET_NAME) + 2)))
+		return ERROR_MEMORY_ALLOC;
+	sprintf(*path, PRIVATE_SOCKET_DIR, (unsigned long)geteuid());
+
+	/*the directory is trusted only if no one else can replace the socket in it*/
+	if (make_dir)
+		mkdir(*path, PRIVATE_DIR_MODE);
+	trusted = !lstat(*path, &info) && S_ISDIR(info.st_mode) && info.st_uid == geteuid() &&
+			  !(info.st_mode & (S_IRWXG | S_IRWXO));
+	strcat(*path, "/" DEFAULT_SOCKET_NAME);
+
+	return trusted ? NO_ERROR : ERROR_LISTEN;
+}
+
+/* socket_peer_is_user : check that the other end of a connection is run by the user
+ * 						 so no one else can use the server or pose as it
+ * parameters          : fd - the connected socket
+ * return              : TRUE if the peer is run by the user else FALSE*/
+int socket_peer_is_user(int fd) {
+	struct ucred peer;
+	socklen_t 	 size = sizeof(peer);
+
+	return !getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &size) &&
+		   size == sizeof(peer) && peer.uid == geteuid();
+}
+
+/* socket_connect : connect to the socket of a server run by the user
+ * parameters     : path - the path of the socket
+ * return         : the connected socket or -1 if there is no server of the user there*/
+int socket_connect(const char *path) {
+	struct sockaddr_un addr;
+	int 			   fd;
+
+	if (!socket_address(&addr, path) || (fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+		return -1;
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) || !socket_peer_is_user(fd)) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+/* socket_listen : listen on the socket of a server, only the user can connect to it,
+ * 				   a socket of the user left by a server that isnt running anymore is
+ * 				   replaced
+ * parameters    : path - the path of the socket
+ * return        : the listening socket or -1 if another server listens there, the path
+ * 				   holds something else or the socket couldnt be made*/
+int socket_listen(const char *path) {
+	struct sockaddr_un addr;
+	struct stat 	   info;
+	mode_t 			   mask;
+	int 			   fd,
+					   bound;
+
+	if ((fd = socket_connect(path)) >= 0) {
+		close(fd);
+		return -1;
+	}
+
+	if (!socket_address(&addr, path) || (fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+		return -1;
+	if (!lstat(path, &info)) {
+		if (!S_ISSOCK(info.st_mode) || info.st_uid != geteuid() || unlink(path)) {
+			close(fd);
+			return -1;
+		}
+	}
+
+	/*the socket is made without permissions for others so no one connects before it
+	 *is restricted*/
+	mask = umask(S_IRWXG | S_IRWXO);
+	bound = !bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+	umask(mask);
+	if (!bound || chmod(path, SOCKET_MODE) || listen(fd, LISTEN_BACKLOG)) {
+		if (bound)
+			unlink(path);
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+/* send_all   : send bytes to a socket, a send may take only part of them
+ * parameters : fd   - the socket
+ * 				data - the bytes to send
+ * 				size - the number of bytes
+ * return     : NO_ERROR      - if all the bytes were sent
+ * 				ERROR_CONNECT - if the connection was lost*/
+static error_value send_all(int fd, const char *data, size_t size) {
+	ssize_t part;
+
+	for (; size; data += part, size -= part)
+		if ((part = write(fd, data, size)) <= 0) {
+			if (part < 0 && errno == EINTR)
+				part = 0;
+			else
+				return ERROR_CONNECT;
+		}
+
+	return NO_ERROR;
+}
+
+/* recv_all   : receive an exact number of bytes from a socket
+ * parameters : fd   - the socket
+ * 				data - the output for the bytes
+ * 				size - the number of bytes
+ * return     : NO_ERROR      - if all the bytes were received
+ * 				ERROR_CONNECT - if the connection was lost or closed before*/
+static error_value recv_all(int fd, char *data, size_t size) {
+	ssize_t part;
+
+	for (; size; data += part, size -= part)
+		if ((part = read(fd, data, size)) <= 0) {
+			if (part < 0 && errno == EINTR)
+				part = 0;
+			else
+				return ERROR_CONNECT;
+		}
+
+	return NO_ERROR;
+}
+
+/* recv_header : receive the first line of a request or a reply, a byte at a time
+ * 				 so nothing after it is taken
+ * parameters  : fd     - the socket
+ * 				 header - the output for the line without its '\n'
+ * return      : NO_ERROR      - if the line was received
+ * 				 ERROR_CONNECT - if the connection was lost or the line is too long*/
+static error_value recv_header(int fd, char header[MAX_HEADER_LEN]) {
+	int i;
+
+	for (i = 0; i < MAX_HEADER_LEN; i++) {
+		if (recv_all(fd, header + i, 1))
+			return ERROR_CONNECT;
+		if (header[i] == '\n') {
+			header[i] = '\0';
+			return NO_ERROR;
+		}
+	}
+
+	return ERROR_CONNECT;
+}
+
+/* recv_text  : receive bytes into a new buffer that ends with '\0'
+ * parameters : fd   - the socket
+ * 				text - the output for the buffer
+ * 				size - the number of bytes
+ * return     : NO_ERROR           - if the bytes were received
+ * 				ERROR_CONNECT      - if the connection was lost
+ * 				ERROR_MEMORY_ALLOC - if the buffer couldnt be allocated*/
+static error_value recv_text(int fd, char **text, const size_t size) {
+	if (!(*text = malloc(size + 1)))
+		return ERROR_MEMORY_ALLOC;
+	(*text)[size] = '\0';
+
+	return recv_all(fd, *text, size);
+}
+
+/* send_request : send a request to a server
+ * parameters   : fd      - the connected socket
+ * 				  request - a pointer to the request
+ * return       : NO_ERROR      - if the request was sent
+ * 				  ERROR_CONNECT - if the connection was lost*/
+error_value send_request(int fd, const asm_request *request) {
+	char header[MAX_HEADER_LEN];
+
+	sprintf(header, "%c %lu %lu\n", request->kind, (unsigned long)strlen(request->name),
+			(unsigned long)request->size);
+	if (send_all(fd, header, strlen(header)) ||
+		send_all(fd, request->name, strlen(request->name)) ||
+		send_all(fd, request->data, request->size))
+		return ERROR_CONNECT;
+
+	return NO_ERROR;
+}
+
+/* recv_request : receive the next request of a client
+ * parameters   : fd      - the connected socket
+ * 				  request - the output for the request, it is released with
+ * 							request_free
+ * return       : NO_ERROR           - if a request was received
+ * 				  ERROR_CONNECT      - if the client is done or the request is invalid
+ * 				  ERROR_MEMORY_ALLOC - if the request couldnt be allocated*/
+error_value recv_request(int fd, asm_request *request) {
+	error_value   err_val;
+	char 		  header[MAX_HEADER_LEN];
+	unsigned long name_len,
+				  size;
+
+	request->name = request->data = NULL;
+	if ((err_val = recv_header(fd, header)))
+		return err_val;
+
+	if (sscanf(header, "%c %lu %lu", &request->kind, &name_len, &size) != 3 ||
+		(request->kind != REQUEST_PATH && request->kind != REQUEST_TEXT) ||
+		!name_len || name_len >= MAX_FILE_NAME_LEN ||
+		size > MAX_REQUEST_SIZE)
+		return ERROR_CONNECT;
+	request->size = size;
+
+	if (!(err_val = recv_text(fd, &request->name, name_len)))
+		err_val = recv_text(fd, &request->data, size);
+	if (!err_val && (strlen(request->name) != name_len ||
+					 (request->kind == REQUEST_PATH && strlen(request->data) != size)))
+		err_val = ERROR_CONNECT;
+
+	if (err_val)
+		request_free(request);
+
+	return err_val;
+}
+
+/* request_free : release what was received for a request
+ * parameters   : request - a pointer to the request
+ * return       :*/
+void request_free(asm_request *request) {
+	free(request->name);
+	free(request->data);
+	request->name = request->data = NULL;
+}
+
+/* reply_init : make an empty reply
+ * parameters : reply - a pointer to the reply
+ * return     :*/
+void reply_init(asm_reply *reply) {
+	int i;
+
+	reply->err_val = NO_ERROR;
+	diagnostics_init(&reply->diag);
+	for (i = 0; i < NUM_OF_OUTPUTS; i++) {
+		reply->outputs[i].data = NULL;
+		reply->outputs[i].size = 0;
+	}
+}
+
+/* send_reply : send the reply to a request to the client
+ * parameters : fd    - the connected socket
+ * 				reply - a pointer to the reply
+ * return     : NO_ERROR      - if the reply was sent
+ * 				ERROR_CONNECT - if the connection was lost*/
+error_value send_reply(int fd, const asm_reply *reply) {
+	char header[MAX_HEADER_LEN];
+	int  i;
+
+	sprintf(header, "%d %lu", reply->err_val, (unsigned long)reply->diag.size);
+	for (i = 0; i < NUM_OF_OUTPUTS; i++)
+		sprintf(header + strlen(header), " %ld", reply->outputs[i].data ?
+				(long)reply->outputs[i].size : -1L);
+	strcat(header, "\n");
+
+	if (send_all(fd, header, strlen(header)) ||
+		send_all(fd, reply->diag.text, reply->diag.size))
+		return ERROR_CONNECT;
+	for (i = 0; i < NUM_OF_OUTPUTS; i++)
+		if (reply->outputs[i].data &&
+			send_all(fd, reply->outputs[i].data, reply->outputs[i].size))
+			return ERROR_CONNECT;
+
+	return NO_ERROR;
+}
+
+/* recv_reply : receive the reply to a request from the server
+ * parameters : fd    - the connected socket
+ * 				reply - the output for the reply, it is released with reply_free
+ * 						if it was received
+ * return     : NO_ERROR           - if the reply was received
+ * 				ERROR_CONNECT      - if the connection was lost or the reply is invalid
+ * 				ERROR_MEMORY_ALLOC - if the reply couldnt be allocated*/
+error_value recv_reply(int fd, asm_reply *reply) {
+	error_value   err_val;
+	char 		  header[MAX_HEADER_LEN];
+	int 		  result,
+				  i;
+	unsigned long diag_size;
+	long 		  sizes[NUM_OF_OUTPUTS];
+
+	reply_init(reply);
+	if ((err_val = recv_header(fd, header)))
+		return err_val;
+	if (sscanf(header, "%d %lu %ld %ld %ld", &result, &diag_size, &sizes[OBJECT_OUTPUT],
+			   &sizes[EXTERN_OUTPUT], &sizes[ENTRY_OUTPUT]) != NUM_OF_OUTPUTS + 2)
+		return ERROR_CONNECT;
+	reply->err_val = result;
+
+	if (diag_size) {
+		if ((err_val = recv_text(fd, &reply->diag.text, diag_size)))
+			return err_val;
+		reply->diag.size = reply->diag.capacity = diag_size;
+	}
+	for (i = 0; !err_val && i < NUM_OF_OUTPUTS; i++)
+		if (sizes[i] >= 0) {
+			err_val = recv_text(fd, &reply->outputs[i].data, sizes[i]);
+			reply->outputs[i].size = sizes[i];
+		}
+
+	if (err_val)
+		reply_free(reply);
+
+	return err_val;
+}
+
+/* reply_free : release the errors and the output files of a reply
+ * parameters : reply - a pointer to the reply
+ * return     :*/
+void reply_free(asm_reply *reply) {
+	int i;
+
+	free(reply->diag.text);
+	for (i = 0; i < NUM_OF_OUTPUTS; i++)
+		free(reply->outputs[i].data);
+	reply_init(reply);
+}
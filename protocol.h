@@ -0,0 +1,55 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "defs.h"
+#include "error.h"
+#include "output.h"
+#include "file_handler.h"
+
+/*the name of the socket the server listens on when no other socket is given, it is
+ * made in the runtime directory of the user*/
+#define DEFAULT_SOCKET_NAME "assembler.sock"
+/*the directory of the socket of a user without a runtime directory, by the user id*/
+#define PRIVATE_SOCKET_DIR "/tmp/assembler-%lu"
+/*the option for the socket of the server*/
+#define SOCKET_OPTION "--socket="
+/*the most bytes of source a request can hold*/
+#define MAX_REQUEST_SIZE (64L * 1024 * 1024)
+
+/*the kinds of requests, a source given by its path or by its text*/
+#define REQUEST_PATH 'P'
+#define REQUEST_TEXT 'T'
+
+/* a struct representing a request to assemble a source
+ * name is the base name of the source as it was given to the client, the errors
+ * are reported by it, data is the full path of the source or its text by the kind
+ * of the request and it always ends with '\0'*/
+typedef struct{
+	char kind;
+	char *name;
+	char *data;
+	size_t size;
+} asm_request;
+
+/* a struct representing the reply to a request
+ * diag holds the errors of the source without the line of its result and outputs
+ * holds the output files it has, only if it was assembled without errors*/
+typedef struct{
+	error_value err_val;
+	diagnostics diag;
+	output_bytes outputs[NUM_OF_OUTPUTS];
+} asm_reply;
+
+error_value default_socket_path(char**, const int);
+int socket_connect(const char*);
+int socket_listen(const char*);
+int socket_peer_is_user(int);
+error_value send_request(int, const asm_request*);
+error_value recv_request(int, asm_request*);
+void request_free(asm_request*);
+void reply_init(asm_reply*);
+error_value send_reply(int, const asm_reply*);
+error_value recv_reply(int, asm_reply*);
+void reply_free(asm_reply*);
+
+#endif
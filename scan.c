@@ -0,0 +1,182 @@
+#include "scan.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*the bits of a block of the pre-scan*/
+#define BLOCK_MASK ((1U << SCAN_BLOCK) - 1)
+
+/*short names for the classes so the table fits the page*/
+#define B CHAR_BLANK
+#define D CHAR_DIGIT
+#define A CHAR_ALPHA
+#define S CHAR_SIGN
+
+/* a table of the classes of every character in the C locale
+ * the characters above 127 are not in any class*/
+const unsigned char char_class[256] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, B, B, B, B, B, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	B, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, S, 0, S, 0, 0,
+	D, D, D, D, D, D, D, D, D, D, 0, 0, 0, 0, 0, 0,
+	0, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A,
+	A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, 0, 0,
+	0, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A,
+	A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, 0, 0
+};
+
+#undef B
+#undef D
+#undef A
+#undef S
+
+/* the positions of the lowest set bit indexed by the top 5 bits of the product of
+ * the bit alone and a de Bruijn sequence*/
+static const unsigned char debruijn_pos[32] = {
+	0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+	31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+
+/* lowest_bit : find the position of the lowest set bit of a block without a loop
+ * parameters : bits - the bits of the block, at least one is set
+ * return     : the position of the lowest set bit*/
+static int lowest_bit(const unsigned int bits) {
+	unsigned long low = bits & (~bits + 1);
+
+	return debruijn_pos[((low * 0x077CB531UL) & 0xFFFFFFFFUL) >> 27];
+}
+
+#ifdef __SSE2__
+
+/* scan_blocks : scan the blanks, commas, ';' and ':' of a line, SSE2 version that
+ * 				 looks at a block of the line with every instruction
+ * parameters  : line - the line to scan, in a buffer of SCAN_LINE_SIZE characters
+ * 				 len  - the length of the line, a '\0' before it ends the line earlier
+ * 				 scan - a pointer to the result of the scan
+ * return      :*/
+static void scan_blocks(const char *line, int len, line_scan *scan) {
+	const __m128i zero = _mm_setzero_si128(),
+				  space = _mm_set1_epi8(' '),
+				  before_tab = _mm_set1_epi8('\t' - 1),
+				  after_cr = _mm_set1_epi8('\r' + 1),
+				  comma = _mm_set1_epi8(','),
+				  semicolon = _mm_set1_epi8(';'),
+				  colon = _mm_set1_epi8(':');
+	__m128i 	  chars;
+	unsigned int  valid,
+				  bits;
+	int 		  b,
+				  base;
+
+	for (b = 0, base = 0; base < len; b++, base += SCAN_BLOCK) {
+		chars = _mm_loadu_si128((const __m128i*)(line + base));
+		valid = len - base >= SCAN_BLOCK ? BLOCK_MASK : (1U << (len - base)) - 1;
+		if ((bits = valid & _mm_movemask_epi8(_mm_cmpeq_epi8(chars, zero)))) {
+			len = base + lowest_bit(bits);
+			valid = (1U << (len - base)) - 1;
+		}
+
+		/*a blank is a space or one of the characters from '\t' to '\r'*/
+		scan->blanks[b] = valid & _mm_movemask_epi8(_mm_or_si128(
+				_mm_cmpeq_epi8(chars, space),
+				_mm_and_si128(_mm_cmpgt_epi8(chars, before_tab),
+							  _mm_cmplt_epi8(chars, after_cr))));
+		scan->commas[b] = valid & _mm_movemask_epi8(_mm_cmpeq_epi8(chars, comma));
+
+		if (scan->comment < 0 &&
+			(bits = valid & _mm_movemask_epi8(_mm_cmpeq_epi8(chars, semicolon))))
+			scan->comment = base + lowest_bit(bits);
+		if (scan->colon < 0 &&
+			(bits = valid & _mm_movemask_epi8(_mm_cmpeq_epi8(chars, colon))))
+			scan->colon = base + lowest_bit(bits);
+	}
+
+	scan->len = len;
+}
+
+#else
+
+/* scan_blocks : scan the blanks, commas, ';' and ':' of a line, portable version
+ * 				 that looks at a character at a time
+ * parameters  : line - the line to scan, in a buffer of SCAN_LINE_SIZE characters
+ * 				 len  - the length of the line, a '\0' before it ends the line earlier
+ * 				 scan - a pointer to the result of the scan
+ * return      :*/
+static void scan_blocks(const char *line, int len, line_scan *scan) {
+	int pos;
+
+	memset(scan->blanks, 0, sizeof(scan->blanks));
+	memset(scan->commas, 0, sizeof(scan->commas));
+	for (pos = 0; pos < len && line[pos]; pos++)
+		if (char_is(line[pos], CHAR_BLANK))
+			scan->blanks[pos / SCAN_BLOCK] |= 1U << (pos % SCAN_BLOCK);
+		else if (line[pos] == ',')
+			scan->commas[pos / SCAN_BLOCK] |= 1U << (pos % SCAN_BLOCK);
+		else if (line[pos] == ';' && scan->comment < 0)
+			scan->comment = pos;
+		else if (line[pos] == ':' && scan->colon < 0)
+			scan->colon = pos;
+
+	scan->len = pos;
+}
+
+#endif
+
+/* scan_line  : pre-scan a line, the blanks at its start are skipped first since a
+ * 				blank or a comment line is recognized there and the rest of it is
+ * 				not scanned
+ * parameters : line - the line to scan, in a buffer of SCAN_LINE_SIZE characters
+ * 				len  - the length of the line, a '\0' before it ends the line earlier
+ * 				scan - a pointer to the result of the scan
+ * return     :*/
+void scan_line(const char *line, int len, line_scan *scan) {
+	int first;
+
+	for (first = 0; first < len && char_is(line[first], CHAR_BLANK); first++);
+
+	/*a '\0' among the blanks at the start ends the line there*/
+	if (first < len && !line[first])
+		len = first;
+
+	scan->first = first;
+	scan->comment = -1;
+	scan->colon = -1;
+	if (first == len)
+		scan->len = len;
+	else if (line[first] == ';') {
+		scan->comment = first;
+		/*only the length of a comment line that may be too long matters*/
+		scan->len = len == MAX_LINE_LEN + 1 ? (int)strlen(line) : len;
+	} else
+		scan_blocks(line, len, scan);
+}
+
+/* scan_next  : find the next position in a line whose bit in the masks of the
+ * 				pre-scan is set or clear
+ * parameters : masks - the masks of the pre-scan to look in
+ * 				pos   - the position to start looking from
+ * 				len   - the length of the line
+ * 				set   - TRUE to look for a set bit, FALSE to look for a clear bit
+ * return     : the position found or len if there is none*/
+int scan_next(const unsigned int *masks, const int pos, const int len, const int set) {
+	int 		 b = pos / SCAN_BLOCK,
+				 found;
+	unsigned int flip = set ? 0 : BLOCK_MASK,
+				 bits;
+
+	if (pos >= len)
+		return len;
+	bits = ((masks[b] ^ flip) >> (pos % SCAN_BLOCK)) << (pos % SCAN_BLOCK);
+
+	/*skip the blocks that have no bit to find, the blocks after the end of the
+	 * line were not scanned*/
+	while (!bits && ++b * SCAN_BLOCK < len)
+		bits = masks[b] ^ flip;
+	if (!bits)
+		return len;
+
+	found = b * SCAN_BLOCK + lowest_bit(bits);
+
+	return found < len ? found : len;
+}
@@ -0,0 +1,43 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include "defs.h"
+
+/*the number of characters the pre-scan looks at in one step*/
+#define SCAN_BLOCK 16
+/*the number of steps that cover the longest line and its terminator*/
+#define SCAN_BLOCKS ((MAX_LINE_LEN + 2 + SCAN_BLOCK - 1) / SCAN_BLOCK)
+/*the size of a line buffer the pre-scan can read whole blocks from*/
+#define SCAN_LINE_SIZE (SCAN_BLOCKS * SCAN_BLOCK)
+
+/*the classes of characters, a character can be in several classes*/
+#define CHAR_BLANK 1
+#define CHAR_DIGIT 2
+#define CHAR_ALPHA 4
+#define CHAR_SIGN 8
+#define CHAR_ALNUM (CHAR_ALPHA | CHAR_DIGIT)
+
+/*check if a character is in one of the given classes*/
+#define char_is(c, classes) (char_class[(unsigned char)(c)] & (classes))
+
+/* a struct representing the result of the pre-scan of a line
+ * first is the position of the first non blank character (len if there is none),
+ * comment and colon are the positions of the first ';' and ':' (-1 if there is none)
+ * a blank or a comment line is only scanned up to its first non blank character
+ * bit i of block b of blanks and commas is set if the character at b * SCAN_BLOCK + i
+ * is a blank or a comma*/
+typedef struct{
+	int len;
+	int first;
+	int comment;
+	int colon;
+	unsigned int blanks[SCAN_BLOCKS];
+	unsigned int commas[SCAN_BLOCKS];
+}line_scan;
+
+extern const unsigned char char_class[];
+
+void scan_line(const char*, int, line_scan*);
+int scan_next(const unsigned int*, const int, const int, const int);
+
+#endif
@@ -0,0 +1,355 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <signal.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include "defs.h"
+#include "error.h"
+#include "context.h"
+#include "job.h"
+#include "source.h"
+#include "protocol.h"
+
+/*the most clients that are served at the same time, the others wait to be accepted*/
+#define MAX_CLIENTS 64
+/*the most assembly contexts that are kept warm between requests*/
+#define MAX_IDLE_CONTEXTS 16
+/*the most memory the arena of a context kept warm holds, a context that grew more
+ * for a big source is released so the server doesnt hold it while it is idle*/
+#define MAX_WARM_ARENA_SIZE (64L * 1024 * 1024)
+
+/* a struct representing the state the clients of the server share
+ * idle holds the assembly contexts that arent used now so the next request finds
+ * its tables already allocated, clients holds the connections that are served so
+ * they can be ended when the server stops
+ * the signals that stop the server are waited for by a thread of their own, it
+ * writes to the wake pipe so the server stops waiting for the next client*/
+typedef struct{
+	assembly_context *idle[MAX_IDLE_CONTEXTS];
+	int num_of_idle;
+	struct client *clients[MAX_CLIENTS];
+	int num_of_clients;
+	int stopping;
+	sigset_t signals;
+	int wake[2];
+	pthread_mutex_t lock;
+	pthread_cond_t client_done;
+} server_state;
+
+/*a struct representing a connection to a client, served by a thread of its own*/
+typedef struct client {
+	server_state *server;
+	int fd;
+	int slot;
+} client;
+
+/* take_context : take a warm assembly context or make a new one if there is none
+ * parameters   : server - a pointer to the state of the server
+ * return       : a pointer to the context or NULL if it couldnt be allocated*/
+static assembly_context *take_context(server_state *server) {
+	assembly_context *context = NULL;
+
+	pthread_mutex_lock(&server->lock);
+	if (server->num_of_idle)
+		context = server->idle[--server->num_of_idle];
+	pthread_mutex_unlock(&server->lock);
+
+	return context ? context : context_init();
+}
+
+/* give_back_context : keep an assembly context warm for the next request, or release
+ * 					   it if enough contexts are kept or it holds too much memory
+ * parameters        : server  - a pointer to the state of the server
+ * 					   context - a pointer to the context
+ * return            :*/
+static void give_back_context(server_state *server, assembly_context *context) {
+	pthread_mutex_lock(&server->lock);
+	if (server->num_of_idle < MAX_IDLE_CONTEXTS &&
+		context->arena->reserved <= MAX_WARM_ARENA_SIZE) {
+		server->idle[server->num_of_idle++] = context;
+		context = NULL;
+	}
+	pthread_mutex_unlock(&server->lock);
+
+	context_free(context);
+}
+
+/* serve_request : assemble the source of a request with a warm context, the output
+ * 				   files are captured for the reply instead of written
+ * parameters    : server  - a pointer to the state of the server
+ * 				   request - a pointer to the request, a text source is taken from it
+ * 				   reply   - the output for the reply
+ * return        :*/
+static void serve_request(server_state *server, asm_request *request, asm_reply *reply) {
+	file_job 		 job;
+	source_file 	 source;
+	assembly_context *context;
+	int 			 i;
+
+	reply_init(reply);
+	if ((reply->err_val = file_job_init(&job, request->name))) {
+		free(job.file_name);
+		return;
+	}
+	job.captured = reply->outputs;
+
+	/*the source is read here so the errors are reported by the name of the request*/
+	if (request->kind == REQUEST_TEXT) {
+		source_text(&source, request->data, request->size);
+		request->data = NULL;
+	} else
+		job.err_val = source_open(&source, request->data);
+
+	if (!job.err_val) {
+		job.source = &source;
+		if ((context = take_context(server))) {
+			assemble_file(context, &job);
+			give_back_context(server, context);
+		} else {
+			source_close(&source);
+			job.err_val = ERROR_MEMORY_ALLOC;
+		}
+	}
+
+	/*the outputs of a source with errors are left out*/
+	if ((reply->err_val = job.err_val))
+		for (i = 0; i < NUM_OF_OUTPUTS; i++) {
+			free(reply->outputs[i].data);
+			reply->outputs[i].data = NULL;
+		}
+	reply->diag = job.diag;
+	free(job.file_name);
+}
+
+/* client_run : the function of the thread of a client, serve its requests one after
+ * 				another until it closes the connection
+ * parameters : arg - a pointer to the client
+ * return     : NULL*/
+static void *client_run(void *arg) {
+	client 		 *self = arg;
+	server_state *server = self->server;
+	asm_request  request;
+	asm_reply 	 reply;
+	int 		 connected = TRUE;
+
+	while (connected && !recv_request(self->fd, &request)) {
+		serve_request(server, &request, &reply);
+		connected = !send_reply(self->fd, &reply);
+		reply_free(&reply);
+		request_free(&request);
+	}
+
+	/*let the server accept another client, the socket is closed while it cant be
+	 *ended by the server*/
+	pthread_mutex_lock(&server->lock);
+	server->clients[self->slot] = NULL;
+	close(self->fd);
+	server->num_of_clients--;
+	pthread_cond_signal(&server->client_done);
+	pthread_mutex_unlock(&server->lock);
+	free(self);
+
+	return NULL;
+}
+
+/* start_client : start the thread that serves a new connection
+ * parameters   : server - a pointer to the state of the server
+ * 				  fd     - the connected socket
+ * return       :*/
+static void start_client(server_state *server, int fd) {
+	pthread_attr_t attr;
+	pthread_t 	   thread;
+	client 		   *new_client;
+	int 		   started = FALSE,
+				   slot = 0;
+
+	/*the thread isnt joined so it releases itself when it ends*/
+	if ((new_client = malloc(sizeof(client)))) {
+		new_client->server = server;
+		new_client->fd = fd;
+
+		/*there is a free slot since only MAX_CLIENTS are accepted*/
+		pthread_mutex_lock(&server->lock);
+		while (server->clients[slot])
+			slot++;
+		new_client->slot = slot;
+		server->clients[slot] = new_client;
+		server->num_of_clients++;
+		pthread_mutex_unlock(&server->lock);
+
+		pthread_attr_init(&attr);
+		pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+		started = !pthread_create(&thread, &attr, client_run, new_client);
+		pthread_attr_destroy(&attr);
+	}
+
+	/*a client that cant be served is dropped*/
+	if (!started) {
+		if (new_client) {
+			pthread_mutex_lock(&server->lock);
+			server->clients[slot] = NULL;
+			server->num_of_clients--;
+			pthread_mutex_unlock(&server->lock);
+		}
+		free(new_client);
+		close(fd);
+	}
+}
+
+/* block_signals : block the signals that stop the server in every thread it starts so
+ * 				   only the thread that waits for them gets them, and keep serving
+ * 				   when a client goes away in the middle of a reply
+ * parameters    : server - a pointer to the state of the server
+ * return        :*/
+static void block_signals(server_state *server) {
+	struct sigaction action;
+
+	sigemptyset(&server->signals);
+	sigaddset(&server->signals, SIGINT);
+	sigaddset(&server->signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &server->signals, NULL);
+
+	memset(&action, 0, sizeof(action));
+	sigemptyset(&action.sa_mask);
+	action.sa_handler = SIG_IGN;
+	sigaction(SIGPIPE, &action, NULL);
+}
+
+/* wait_signals : the function of the thread that waits for a signal to stop the
+ * 				  server, it wakes the server whether it waits for a client to connect
+ * 				  or for one to end
+ * parameters   : arg - a pointer to the state of the server
+ * return       : NULL*/
+static void *wait_signals(void *arg) {
+	server_state *server = arg;
+	int 		 sig;
+
+	while (sigwait(&server->signals, &sig))
+		;
+
+	pthread_mutex_lock(&server->lock);
+	server->stopping = TRUE;
+	pthread_cond_broadcast(&server->client_done);
+	pthread_mutex_unlock(&server->lock);
+	while (write(server->wake[1], "", 1) < 0 && errno == EINTR)
+		;
+
+	return NULL;
+}
+
+/* wait_for_slot : wait until another client can be served
+ * parameters    : server - a pointer to the state of the server
+ * return        : TRUE if a client can be served or FALSE if the server stops*/
+static int wait_for_slot(server_state *server) {
+	int running;
+
+	pthread_mutex_lock(&server->lock);
+	while (server->num_of_clients >= MAX_CLIENTS && !server->stopping)
+		pthread_cond_wait(&server->client_done, &server->lock);
+	running = !server->stopping;
+	pthread_mutex_unlock(&server->lock);
+
+	return running;
+}
+
+/* stop_clients : end the connections of the clients after the requests they are
+ * 				  served and wait for their threads, so nothing is used after the
+ * 				  server releases it
+ * parameters   : server - a pointer to the state of the server
+ * return       :*/
+static void stop_clients(server_state *server) {
+	int i;
+
+	pthread_mutex_lock(&server->lock);
+	for (i = 0; i < MAX_CLIENTS; i++)
+		if (server->clients[i])
+			shutdown(server->clients[i]->fd, SHUT_RD);
+	while (server->num_of_clients)
+		pthread_cond_wait(&server->client_done, &server->lock);
+	while (server->num_of_idle)
+		context_free(server->idle[--server->num_of_idle]);
+	pthread_mutex_unlock(&server->lock);
+}
+
+/* entry point */
+int main(int argc, char **argv) {
+	error_value	  err_val = NO_ERROR;
+	server_state  server;
+	struct pollfd ready[2];
+	pthread_t 	  signal_thread;
+	char 		  *socket_path = NULL;
+	int 		  listen_fd = -1,
+				  fd,
+				  i;
+
+	/*the only option is the socket to listen on*/
+	if (argc > 2 || (argc == 2 && (strncmp(argv[1], SOCKET_OPTION, strlen(SOCKET_OPTION)) ||
+								   !argv[1][strlen(SOCKET_OPTION)]))) {
+		print_error(INVALID_OPTION, argv[argc - 1], 0);
+		return EXIT_FAILURE;
+	}
+	if (argc == 2)
+		socket_path = argv[1] + strlen(SOCKET_OPTION);
+	else
+		err_val = default_socket_path(&socket_path, TRUE);
+
+	/*the signals are blocked before any thread starts so they all inherit it*/
+	block_signals(&server);
+	server.num_of_idle = 0;
+	server.num_of_clients = 0;
+	server.stopping = FALSE;
+	for (i = 0; i < MAX_CLIENTS; i++)
+		server.clients[i] = NULL;
+	pthread_mutex_init(&server.lock, NULL);
+	pthread_cond_init(&server.client_done, NULL);
+
+	if (err_val || pipe(server.wake) ||
+		pthread_create(&signal_thread, NULL, wait_signals, &server) ||
+		(listen_fd = socket_listen(socket_path)) < 0) {
+		print_error(err_val ? err_val : ERROR_LISTEN,
+					socket_path ? socket_path : DEFAULT_SOCKET_NAME, 0);
+		if (argc < 2)
+			free(socket_path);
+		return EXIT_FAILURE;
+	}
+	printf("%s: listening\n", socket_path);
+	fflush(stdout);
+
+	/*the socket is polled next to the wake pipe so a signal isnt missed while the
+	 *server waits for a client, and it doesnt block if the client went away since*/
+	fcntl(listen_fd, F_SETFL, fcntl(listen_fd, F_GETFL) | O_NONBLOCK);
+	ready[0].fd = listen_fd;
+	ready[1].fd = server.wake[0];
+	ready[0].events = ready[1].events = POLLIN;
+
+	/*every client gets a thread, when there are too many the next one waits*/
+	while (wait_for_slot(&server))
+		if (poll(ready, 2, -1) > 0 && (ready[0].revents & POLLIN) &&
+			(fd = accept(listen_fd, NULL, NULL)) >= 0) {
+			/*a connection of another user is dropped before it is read*/
+			if (socket_peer_is_user(fd))
+				start_client(&server, fd);
+			else
+				close(fd);
+		}
+
+	/*no client is accepted anymore, the ones that are served end before the
+	 *contexts are released*/
+	close(listen_fd);
+	unlink(socket_path);
+	stop_clients(&server);
+	pthread_join(signal_thread, NULL);
+	close(server.wake[0]);
+	close(server.wake[1]);
+	pthread_cond_destroy(&server.client_done);
+	pthread_mutex_destroy(&server.lock);
+	if (argc < 2)
+		free(socket_path);
+
+	return EXIT_SUCCESS;
+}
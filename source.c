@@ -0,0 +1,129 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "source.h"
+
+/*the size of the first buffer when a file is read instead of mapped*/
+#define READ_INIT_CAPACITY 4096
+
+/* read_all   : read everything from a file descriptor into a buffer
+ * parameters : fd     - the file descriptor to read from
+ * 				source - a pointer to the source file to fill
+ * return     : NO_ERROR           - if the file was read
+ * 				ERROR_MEMORY_ALLOC - if the buffer couldnt grow
+ * 				ERROR_OPEN_FILE    - if the file couldnt be read*/
+static error_value read_all(int fd, source_file *source) {
+	size_t  capacity = READ_INIT_CAPACITY;
+	ssize_t len;
+	char 	*data;
+
+	if (!(source->data = malloc(capacity)))
+		return ERROR_MEMORY_ALLOC;
+
+	/*read until the end of the file, doubling the buffer when it is full*/
+	while ((len = read(fd, source->data + source->size, capacity - source->size))) {
+		if (len < 0)
+			return ERROR_OPEN_FILE;
+		if ((source->size += len) == capacity) {
+			if (!(data = realloc(source->data, 2 * capacity)))
+				return ERROR_MEMORY_ALLOC;
+			source->data = data;
+			capacity *= 2;
+		}
+	}
+
+	return NO_ERROR;
+}
+
+/* source_open : map a source file to memory or read it if it cant be mapped
+ * parameters  : source    - a pointer to the source file to open
+ * 				 file_name - the name of the file
+ * return      : NO_ERROR           - if the file is ready to be read
+ * 				 INVALID_FILE_NAME  - if the file doesnt exist or cant be opened
+ * 				 ERROR_OPEN_FILE    - if the file couldnt be read
+ * 				 ERROR_MEMORY_ALLOC - if there was an error allocating the buffer*/
+error_value source_open(source_file *source, const char *file_name) {
+	error_value err_val = NO_ERROR;
+	struct stat st;
+	void		*data;
+	int 		fd;
+
+	source->data = NULL;
+	source->size = 0;
+	source->pos = 0;
+	source->mapped = FALSE;
+
+	if ((fd = open(file_name, O_RDONLY)) < 0)
+		return INVALID_FILE_NAME;
+
+	/*a regular file is mapped as is, an empty one has nothing to map*/
+	if (!fstat(fd, &st) && S_ISREG(st.st_mode)) {
+		if (st.st_size > 0 && (data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+										   fd, 0)) != MAP_FAILED) {
+			source->data = data;
+			source->size = st.st_size;
+			source->mapped = TRUE;
+			posix_madvise(data, st.st_size, POSIX_MADV_SEQUENTIAL);
+		}
+	}
+
+	/*anything that wasnt mapped is read at once*/
+	if (!source->mapped && (err_val = read_all(fd, source)))
+		source_close(source);
+
+	close(fd);
+
+	return err_val;
+}
+
+/* source_text : make a source file of text that is already in memory, the source
+ * 				 takes the text and releases it when it is closed
+ * parameters  : source - a pointer to the source file to make
+ * 				 text   - the text, allocated with malloc
+ * 				 size   - the size of the text
+ * return      :*/
+void source_text(source_file *source, char *text, const size_t size) {
+	source->data = text;
+	source->size = size;
+	source->pos = 0;
+	source->mapped = FALSE;
+}
+
+/* source_next_line : get the next line of a source file
+ * parameters       : source - a pointer to the source file
+ * 					  line   - the output for the line
+ * return           : non zero value if there was a line else zero*/
+int source_next_line(source_file *source, line_slice *line) {
+	size_t left = source->size - source->pos;
+	char   *end;
+
+	if (!left)
+		return FALSE;
+
+	/*the line ends after the first '\n' if it isnt too long*/
+	if (left > MAX_SLICE_LEN)
+		left = MAX_SLICE_LEN;
+	line->text = source->data + source->pos;
+	line->len = (end = memchr(line->text, '\n', left)) ? end - line->text + 1 : left;
+	source->pos += line->len;
+
+	return TRUE;
+}
+
+/* source_close : release a source file
+ * parameters   : source - a pointer to the source file
+ * return       :*/
+void source_close(source_file *source) {
+	if (source->mapped)
+		munmap(source->data, source->size);
+	else
+		free(source->data);
+
+	source->data = NULL;
+	source->size = 0;
+	source->mapped = FALSE;
+}
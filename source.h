@@ -0,0 +1,32 @@
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include "defs.h"
+#include "error.h"
+
+/*the most characters of the source that are handled as one line*/
+#define MAX_SLICE_LEN (MAX_LINE_LEN + 1)
+
+/* a struct representing a line of a source file, pointing into the file itself
+ * a line ends after its '\n' or after MAX_SLICE_LEN characters, the rest of a
+ * longer line is the next line, like reading it with fgets*/
+typedef struct{
+	const char *text;
+	int len;
+} line_slice;
+
+/* a struct representing a source file in memory
+ * a regular file is mapped, anything else (like a pipe) is read at once*/
+typedef struct{
+	char *data;
+	size_t size;
+	size_t pos;
+	int mapped;
+} source_file;
+
+error_value source_open(source_file*, const char*);
+void source_text(source_file*, char*, const size_t);
+int source_next_line(source_file*, line_slice*);
+void source_close(source_file*);
+
+#endif
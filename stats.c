@@ -0,0 +1,193 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <time.h>
+#include "stats.h"
+
+/*the names of the phases as they are printed*/
+static const char *phase_names[NUM_OF_STATS_PHASES] = {
+	"read", "pass1", "pass2_prep", "pass2", "object_file", "extern_file", "entry_file",
+	"total"
+};
+
+/*the names of the types of lines as they are printed, the last are the empty,
+ * comment and invalid lines*/
+static const char *line_type_names[UNDEF_TYPE + 1] = {
+	"macro", "directive", "instruction", "other"
+};
+
+/*the names of the parts of the assembler the memory is counted for*/
+static const char *arena_tag_names[NUM_OF_ARENA_TAGS] = {
+	"symtable", "code", "data", "ir", "parser", "other"
+};
+
+/* clock_seconds : read a clock
+ * parameters    : clock_id - the clock to read
+ * return        : the time of the clock in seconds*/
+static double clock_seconds(clockid_t clock_id) {
+	struct timespec now;
+
+	if (clock_gettime(clock_id, &now))
+		return 0;
+
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* stats_clock : read the clock the phases are timed with
+ * parameters  :
+ * return      : the time in seconds from a fixed point in the past*/
+double stats_clock() {
+	return clock_seconds(CLOCK_MONOTONIC);
+}
+
+/* print_json_string : print a string as a JSON string with its quotes
+ * parameters        : fp  - the file to print to
+ * 					   str - the string to print
+ * return            :*/
+void print_json_string(FILE *fp, const char *str) {
+	putc('"', fp);
+	for (; *str; str++)
+		if (*str == '"' || *str == '\\')
+			fprintf(fp, "\\%c", *str);
+		else if ((unsigned char)*str < ' ')
+			fprintf(fp, "\\u%04x", *str);
+		else
+			putc(*str, fp);
+	putc('"', fp);
+}
+
+/* stats_init : clear the statistics of a file
+ * parameters : stats  - a pointer to the statistics
+ * 				format - the form they are printed in
+ * return     :*/
+void stats_init(assembly_stats *stats, const stats_format format) {
+	memset(stats, 0, sizeof(assembly_stats));
+	stats->format = format;
+}
+
+/* stats_start : start timing a phase, the cpu time is of the thread so it is right
+ * 				 when the files are assembled in parallel
+ * parameters  : stats - a pointer to the statistics or NULL if they are off
+ * 				 start - the output for the time the phase started
+ * return      :*/
+void stats_start(assembly_stats *stats, stats_time *start) {
+	if (stats) {
+		start->wall = clock_seconds(CLOCK_MONOTONIC);
+		start->cpu = clock_seconds(CLOCK_THREAD_CPUTIME_ID);
+	}
+}
+
+/* stats_stop : stop timing a phase and add the time to it
+ * parameters : stats - a pointer to the statistics or NULL if they are off
+ * 				phase - the phase that was timed
+ * 				start - the time the phase started
+ * return     :*/
+void stats_stop(assembly_stats *stats, const stats_phase phase, const stats_time *start) {
+	if (stats) {
+		if (!stats->phases[phase].begin)
+			stats->phases[phase].begin = start->wall;
+		stats->phases[phase].wall += clock_seconds(CLOCK_MONOTONIC) - start->wall;
+		stats->phases[phase].cpu += clock_seconds(CLOCK_THREAD_CPUTIME_ID) - start->cpu;
+	}
+}
+
+/* stats_collect : collect the counters of the tables of a file after it is assembled
+ * 				   every call to add_symbol adds an entry and every call to add_code
+ * 				   adds a word so they are counted by the size of the tables
+ * parameters    : stats      - a pointer to the statistics
+ * 				   arena_p    - a pointer to the arena the file was assembled in
+ * 				   mem_img    - a pointer to the memory image of the file
+ * 				   symtable_p - a pointer to the symbol table of the file
+ * return        :*/
+void stats_collect(assembly_stats *stats, arena *arena_p, memory_image *mem_img,
+				   symtable *symtable_p) {
+	stats->symbols_added = symtable_p->table_size;
+	stats->symbol_lookups = symtable_p->lookups;
+	stats->name_compares = symtable_p->compares;
+	stats->code_words = mem_img->code->ic;
+	stats->code_reallocs = mem_img->code->reallocs;
+	stats->data_words = mem_img->data->dc;
+	stats->data_reallocs = mem_img->data->reallocs;
+	memcpy(stats->memory, arena_p->counts, sizeof(stats->memory));
+	stats->arena_used = arena_p->used;
+	stats->arena_reserved = arena_p->reserved;
+}
+
+/* print_text : print the statistics of a file in a table
+ * parameters : stats     - a pointer to the statistics
+ * 				file_name - the name of the file
+ * return     :*/
+static void print_text(const assembly_stats *stats, const char *file_name) {
+	int i;
+
+	printf("%s: stats\n", file_name);
+	printf("  %-14s %12s %12s\n", "phase", "wall (ms)", "cpu (ms)");
+	for (i = 0; i < NUM_OF_STATS_PHASES; i++)
+		printf("  %-14s %12.3f %12.3f\n", phase_names[i], 1e3 * stats->phases[i].wall,
+			   1e3 * stats->phases[i].cpu);
+
+	printf("  lines         ");
+	for (i = 0; i <= UNDEF_TYPE; i++)
+		printf(" %s %ld", line_type_names[i], stats->lines[i]);
+	printf("\n  symbols        added %ld lookups %ld compares %ld\n",
+		   stats->symbols_added, stats->symbol_lookups, stats->name_compares);
+	printf("  code           words %ld reallocations %ld\n", stats->code_words,
+		   stats->code_reallocs);
+	printf("  data           words %ld reallocations %ld\n", stats->data_words,
+		   stats->data_reallocs);
+	printf("  bytes written  %ld\n", stats->bytes_written);
+	printf("  cache hit      %s\n", stats->cache_hit ? "yes" : "no");
+
+	printf("  %-14s %8s %8s %12s %12s\n", "memory", "allocs", "reallocs", "requested",
+		   "peak");
+	for (i = 0; i < NUM_OF_ARENA_TAGS; i++)
+		printf("    %-12s %8ld %8ld %12ld %12ld\n", arena_tag_names[i],
+			   stats->memory[i].allocs, stats->memory[i].reallocs,
+			   stats->memory[i].requested, stats->memory[i].peak);
+	printf("  arena          used %ld reserved %ld\n", stats->arena_used,
+		   stats->arena_reserved);
+}
+
+/* print_json : print the statistics of a file as a JSON object on one line
+ * parameters : stats     - a pointer to the statistics
+ * 				file_name - the name of the file
+ * return     :*/
+static void print_json(const assembly_stats *stats, const char *file_name) {
+	int i;
+
+	printf("{\"file\": ");
+	print_json_string(stdout, file_name);
+	printf(", \"phases\": {");
+	for (i = 0; i < NUM_OF_STATS_PHASES; i++)
+		printf("%s\"%s\": {\"wall\": %.6f, \"cpu\": %.6f}", i ? ", " : "",
+			   phase_names[i], stats->phases[i].wall, stats->phases[i].cpu);
+
+	printf("}, \"lines\": {");
+	for (i = 0; i <= UNDEF_TYPE; i++)
+		printf("%s\"%s\": %ld", i ? ", " : "", line_type_names[i], stats->lines[i]);
+	printf("}, \"symbols\": {\"added\": %ld, \"lookups\": %ld, \"compares\": %ld}",
+		   stats->symbols_added, stats->symbol_lookups, stats->name_compares);
+	printf(", \"code\": {\"words\": %ld, \"reallocs\": %ld}", stats->code_words,
+		   stats->code_reallocs);
+	printf(", \"data\": {\"words\": %ld, \"reallocs\": %ld}", stats->data_words,
+		   stats->data_reallocs);
+	printf(", \"bytes_written\": %ld, \"cache_hit\": %s, \"memory\": {",
+		   stats->bytes_written, stats->cache_hit ? "true" : "false");
+	for (i = 0; i < NUM_OF_ARENA_TAGS; i++)
+		printf("%s\"%s\": {\"allocs\": %ld, \"reallocs\": %ld, \"requested\": %ld, "
+			   "\"peak\": %ld}", i ? ", " : "", arena_tag_names[i], stats->memory[i].allocs,
+			   stats->memory[i].reallocs, stats->memory[i].requested,
+			   stats->memory[i].peak);
+	printf("}, \"arena\": {\"used\": %ld, \"reserved\": %ld}}\n", stats->arena_used,
+		   stats->arena_reserved);
+}
+
+/* stats_print : print the statistics of a file in the form they were asked for
+ * parameters  : stats     - a pointer to the statistics
+ * 				 file_name - the name of the file
+ * return      :*/
+void stats_print(const assembly_stats *stats, const char *file_name) {
+	if (stats->format == STATS_JSON)
+		print_json(stats, file_name);
+	else
+		print_text(stats, file_name);
+}
@@ -0,0 +1,73 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "defs.h"
+#include "arena.h"
+#include "memory_image.h"
+#include "symtable.h"
+#include "parser.h"
+
+/*the forms the statistics are printed in*/
+typedef enum{
+	STATS_OFF,
+	STATS_TEXT,
+	STATS_JSON
+} stats_format;
+
+/*the phases of the assembly of a file that are timed*/
+typedef enum{
+	STATS_READ,
+	STATS_PASS1,
+	STATS_PASS2_PREP,
+	STATS_PASS2,
+	STATS_OBJECT_FILE,
+	STATS_EXTERN_FILE,
+	STATS_ENTRY_FILE,
+	STATS_TOTAL,
+	NUM_OF_STATS_PHASES
+} stats_phase;
+
+/* a struct representing the time a phase took on the clock and on the cpu
+ * begin is when it first started on the clock, for the trace*/
+typedef struct{
+	double wall;
+	double cpu;
+	double begin;
+} stats_time;
+
+/* a struct representing the statistics of the assembly of a file
+ * a file has them only when they were asked for, the phases are timed with
+ * stats_start and stats_stop that do nothing without them, the lines are counted
+ * by the first pass and the other counters are collected from the tables when
+ * the file is done, cache_hit is TRUE if its output files were taken from the build
+ * cache instead of assembling it
+ * memory is what every part of the assembler allocated from the arena of the file,
+ * arena_used is all the arena gave out for the file and arena_reserved is the size
+ * of its blocks, what a worker holds after the largest file it assembled*/
+typedef struct{
+	stats_format format;
+	stats_time phases[NUM_OF_STATS_PHASES];
+	long lines[UNDEF_TYPE + 1];
+	long symbols_added;
+	long symbol_lookups;
+	long name_compares;
+	long code_words;
+	long code_reallocs;
+	long data_words;
+	long data_reallocs;
+	long bytes_written;
+	int cache_hit;
+	arena_counts memory[NUM_OF_ARENA_TAGS];
+	long arena_used;
+	long arena_reserved;
+} assembly_stats;
+
+double stats_clock();
+void print_json_string(FILE*, const char*);
+void stats_init(assembly_stats*, const stats_format);
+void stats_start(assembly_stats*, stats_time*);
+void stats_stop(assembly_stats*, const stats_phase, const stats_time*);
+void stats_collect(assembly_stats*, arena*, memory_image*, symtable*);
+void stats_print(const assembly_stats*, const char*);
+
+#endif
@@ -1,31 +1,121 @@
 #include "symtable.h"
 
-/* symtable_init : allocate and initialize a symbol table
- * parameters    :
+/*the number of entries a new symbol table has room for*/
+#define SYMTABLE_INIT_CAPACITY 16
+/*the number of slots in the index of a new symbol table (must be a power of 2)*/
+#define SYMTABLE_INIT_INDEX_SIZE 32
+
+/*values for the FNV-1a hash of the symbols names*/
+#define HASH_OFFSET_BASIS 2166136261U
+#define HASH_PRIME 16777619U
+#define HASH_MASK 0xFFFFFFFFU
+
+/* hash_name  : calculate the hash value of a symbol name
+ * parameters : name - the name to hash
+ * 				len  - the length of the name
+ * return     : the hash value of the name*/
+static name_hash hash_name(const char *name, const int len) {
+	name_hash hash = HASH_OFFSET_BASIS;
+	int 	  i;
+
+	for (i = 0; i < len; i++)
+		hash = ((hash ^ (unsigned char)name[i]) * HASH_PRIME) & HASH_MASK;
+
+	return hash;
+}
+
+/* find_slot  : find the slot in the index of the symbol table that holds the given name
+ * 				or the empty slot where the name should be inserted
+ * parameters : symtable_p - a pointer to a symbol table
+ * 				name       - the name to look for, it does not have to be terminated
+ * 				len        - the length of the name
+ * 				hash       - the hash value of the name
+ * return     : the number of the slot in the index*/
+static int find_slot(symtable *symtable_p, const char *name, const int len,
+					 const name_hash hash) {
+	int 		   mask = symtable_p->index_size - 1,
+				   slot = (int)(hash & mask);
+	symtable_slot  *index = symtable_p->index;
+	symtable_entry *entry;
+
+	/* probe the following slots until we find the name or an empty slot
+	 * the hashes are in the slots so an entry is read only when they match*/
+	for (; index[slot].pos; slot = (slot + 1) & mask)
+		if (index[slot].hash == hash) {
+			if (symtable_p->count_flag)
+				symtable_p->compares++;
+			entry = &symtable_p->symtable_entries[index[slot].pos - 1];
+			if (!strncmp(entry->name, name, len) && !entry->name[len])
+				break;
+		}
+
+	return slot;
+}
+
+/* grow_index : double the number of slots in the index of the symbol table
+ * 				and rehash all the entries into it
+ * parameters : symtable_p - a pointer to a symbol table
+ * return     : NO_ERROR           - if the index grew succesfully
+ * 				ERROR_MEMORY_ALLOC - if a memory allocation error occured*/
+static error_value grow_index(symtable *symtable_p) {
+	symtable_slot *new_index;
+	int 		  new_size = symtable_p->index_size * 2,
+				  mask = new_size - 1,
+				  slot,
+				  i;
+
+	if (!(new_index = arena_alloc(symtable_p->arena, ARENA_SYMTABLE,
+								  new_size * sizeof(symtable_slot))))
+		return ERROR_MEMORY_ALLOC;
+	memset(new_index, 0, new_size * sizeof(symtable_slot));
+
+	/*move every used slot to its place in the new index by the hash it holds
+	 * the names are already unique so we only look for an empty slot*/
+	for (i = 0; i < symtable_p->index_size; i++)
+		if (symtable_p->index[i].pos) {
+			slot = (int)(symtable_p->index[i].hash & mask);
+			while (new_index[slot].pos)
+				slot = (slot + 1) & mask;
+			new_index[slot] = symtable_p->index[i];
+		}
+
+	symtable_p->index = new_index;
+	symtable_p->index_size = new_size;
+
+	return NO_ERROR;
+}
+
+/* symtable_init : allocate and initialize a symbol table from an arena
+ * parameters    : arena_p - a pointer to the arena that owns the table
  * return        : if succesfuly allocated the return a pointer to a symbol table
  * 				   else return NULL*/
-symtable *symtable_init() {
+symtable *symtable_init(arena *arena_p) {
 	symtable *symtable_p;
 
 	/*try to allocate memory and initialize a symbol table*/
-	if ((symtable_p = malloc(sizeof(symtable)))) {
-		symtable_p->table_size = 1;
+	if ((symtable_p = arena_alloc(arena_p, ARENA_SYMTABLE, sizeof(symtable)))) {
+		symtable_p->table_size = 0;
+		symtable_p->capacity = SYMTABLE_INIT_CAPACITY;
+		symtable_p->index_size = SYMTABLE_INIT_INDEX_SIZE;
 		symtable_p->entry_flag = FALSE;
-		symtable_p->symtable_entries = malloc(sizeof(symtable_entry));
+		symtable_p->count_flag = FALSE;
+		symtable_p->lookups = 0;
+		symtable_p->compares = 0;
+		symtable_p->arena = arena_p;
+
+		/*if one of the arrays couldnt be allocated the table cant be used*/
+		if (!(symtable_p->symtable_entries = arena_alloc(arena_p, ARENA_SYMTABLE,
+				SYMTABLE_INIT_CAPACITY * sizeof(symtable_entry))) ||
+			!(symtable_p->index = arena_alloc(arena_p, ARENA_SYMTABLE,
+				SYMTABLE_INIT_INDEX_SIZE * sizeof(symtable_slot))))
+			symtable_p = NULL;
+		else
+			memset(symtable_p->index, 0, SYMTABLE_INIT_INDEX_SIZE * sizeof(symtable_slot));
 	}
 
 	return symtable_p;
 }
 
-/* symtable_free : free a previously allocated symbol table
- * parameters    : symtable_p - a pointer to a symbol table to free
- * return        :
- */
-void symtable_free(symtable *symtable_p) {
-	free(symtable_p->symtable_entries);
-	free(symtable_p);
-}
-
 /* add_symbol : add a symbol to the symbol table
  * parameters : symtable_p - a pointer to a symbol table
  * 				name  - the name of the symbol to add
@@ -35,22 +125,45 @@ void symtable_free(symtable *symtable_p) {
  * 				ERROR_MEMORY_ALLOC - if a memory allocation error occured*/
 error_value add_symbol(symtable *symtable_p, const char *name, const int value,
 					   symbol_type type) {
-	error_value err_val = NO_ERROR;
+	error_value    err_val = NO_ERROR;
+	symtable_entry *entries,
+				   *entry;
+	name_hash 	   hash;
+	int 		   slot,
+				   len = strlen(name);
+
+	/*if the entries array is full double its size*/
+	if (symtable_p->table_size == symtable_p->capacity) {
+		if ((entries = arena_realloc(symtable_p->arena, ARENA_SYMTABLE,
+				symtable_p->symtable_entries, symtable_p->capacity * sizeof(symtable_entry),
+				2 * symtable_p->capacity * sizeof(symtable_entry)))) {
+			symtable_p->symtable_entries = entries;
+			symtable_p->capacity *= 2;
+		} else
+			err_val = ERROR_MEMORY_ALLOC;
+	}
 
-	/*if it is not the first entry increase the table size by one*/
-	if(symtable_p->table_size > 1)
-		symtable_p->symtable_entries = realloc(symtable_p->symtable_entries,
-				(symtable_p->table_size) * sizeof(symtable_entry));
+	/*keep the index at most half full so the probe sequences stay short*/
+	if (!err_val && 2 * (symtable_p->table_size + 1) > symtable_p->index_size)
+		err_val = grow_index(symtable_p);
 
 	/*if allocated succesfully then update its variables */
-	if (symtable_p->symtable_entries) {
-		strcpy(symtable_p->symtable_entries[symtable_p->table_size - 1].name,
-				name);
-		symtable_p->symtable_entries[symtable_p->table_size - 1].type = type;
-		symtable_p->symtable_entries[symtable_p->table_size - 1].value = value;
+	if (!err_val) {
+		entry = &symtable_p->symtable_entries[symtable_p->table_size];
+		strcpy(entry->name, name);
+		entry->type = type;
+		entry->value = value;
+		hash = hash_name(name, len);
+
+		/*index the new entry unless a symbol with the same name is already indexed*/
+		slot = find_slot(symtable_p, name, len, hash);
+		if (!symtable_p->index[slot].pos) {
+			symtable_p->index[slot].hash = hash;
+			symtable_p->index[slot].pos = symtable_p->table_size + 1;
+		}
+
 		symtable_p->table_size++;
-	} else
-		err_val = ERROR_MEMORY_ALLOC;
+	}
 
 	return err_val;
 }
@@ -61,18 +174,23 @@ error_value add_symbol(symtable *symtable_p, const char *name, const int value,
  * return      : if a symbol if found return a pointer to it
  *				 else return NULL */
 symtable_entry *find_symbol(const char *name, symtable *symtable_p) {
-	int i = -1;
-
-	/*check if the symbol table is empty */
-	if (symtable_p->symtable_entries)
-		/*if no then itterate over it and look for the name of the symbol*/
-		for (i = 0;
-			 i < symtable_p->table_size &&
-			 strcmp(name, symtable_p->symtable_entries[i].name);
-			 i++);
-
-	return (i < 0 || i == symtable_p->table_size) ?
-			NULL : &symtable_p->symtable_entries[i];
+	return find_symbol_n(name, strlen(name), symtable_p);
+}
+
+/* find_symbol_n : find a symbol by a name that is a part of a longer string
+ * parameters    : name       - the start of the name of the symbol to find
+ * 				   len        - the length of the name
+ * 				   symtable_p - a pointer to a symbol table
+ * return        : if a symbol if found return a pointer to it
+ *				   else return NULL */
+symtable_entry *find_symbol_n(const char *name, const int len, symtable *symtable_p) {
+	int pos;
+
+	if (symtable_p->count_flag)
+		symtable_p->lookups++;
+	pos = symtable_p->index[find_slot(symtable_p, name, len, hash_name(name, len))].pos;
+
+	return pos ? &symtable_p->symtable_entries[pos - 1] : NULL;
 }
 
 /* find_macro : find a macro by name in the symbol table
@@ -81,19 +199,19 @@ symtable_entry *find_symbol(const char *name, symtable *symtable_p) {
  * return     : if a macro is found return a pointer to it
  * 				else return NULL */
 symtable_entry *find_macro(const char *name, symtable *symtable_p) {
-	int i = -1;
-
-	/*check if the symbol table is empty */
-	if (symtable_p->symtable_entries)
-		/*if no then itterate over it and look for the name of the macro*/
-		for (i = 0;
-			 i < symtable_p->table_size &&
-			 (strcmp(symtable_p->symtable_entries[i].name, name) &&
-			 symtable_p->symtable_entries[i].type != MACRO);
-			 i++);
-
-	return (i < 0 || i == symtable_p->table_size) ?
-			NULL : &symtable_p->symtable_entries[i];
+	return find_macro_n(name, strlen(name), symtable_p);
+}
+
+/* find_macro_n : find a macro by a name that is a part of a longer string
+ * paraeters    : name       - the start of the name of the macro
+ * 				  len        - the length of the name
+ * 				  symtable_p - a pointer to a symbol table
+ * return       : if a macro is found return a pointer to it
+ * 				  else return NULL */
+symtable_entry *find_macro_n(const char *name, const int len, symtable *symtable_p) {
+	symtable_entry *entry = find_symbol_n(name, len, symtable_p);
+
+	return entry && entry->type == MACRO ? entry : NULL;
 }
 
 /* update_data_sym_values : update the data symbol to their new address after the first pass
@@ -103,11 +221,9 @@ symtable_entry *find_macro(const char *name, symtable *symtable_p) {
 void update_data_sym_values(symtable *symtable_p, const int ic) {
 	int i;
 
-	/*check if the symbol table is empty */
-	if(symtable_p->symtable_entries)
-		/*if no the itterate over it and update every data value*/
-		for (i = 0; i < symtable_p->table_size; i++) {
-			if (symtable_p->symtable_entries[i].type == DATA)
-				symtable_p->symtable_entries[i].value += (ADDRESS_OFFSET + ic);
-		}
+	/*itterate over the symbol table and update every data value*/
+	for (i = 0; i < symtable_p->table_size; i++) {
+		if (symtable_p->symtable_entries[i].type == DATA)
+			symtable_p->symtable_entries[i].value += (ADDRESS_OFFSET + ic);
+	}
 }
@@ -3,6 +3,7 @@
 
 #include "defs.h"
 #include "error.h"
+#include "arena.h"
 #include "symtable.h"
 
 /*enum for the types of symbols*/
@@ -10,24 +11,48 @@ typedef enum symbol_types {
 	DATA, CODE, EXTERNAL, MACRO, ENTRY
 } symbol_type;
 
+/*the 32 bit hash of a symbol name, an unsigned int has 32 bits wherever the
+ * assembler is built*/
+typedef unsigned int name_hash;
+
 /*a struct of a symbol table entry*/
 typedef struct{
-	char name[MAX_LABEL_LEN];
+	char name[MAX_LABEL_LEN + 1];
 	int value;
 	symbol_type type;
 } symtable_entry;
 
-/*a struct representing a symbol table*/
+/* a struct of a slot of the index of a symbol table, the hash of the name of its
+ * entry is kept next to the position of the entry so a probe reads the entry only
+ * when the hashes match*/
+typedef struct{
+	name_hash hash;
+	int pos;
+} symtable_slot;
+
+/* a struct representing a symbol table
+ * the entries are kept in insertion order and the index is an open addressing
+ * hash table of entry positions (position + 1, 0 marks an empty slot)
+ * lookups and compares count the lookups and the names compared for the stats,
+ * only while count_flag is set so the lookups dont pay for them otherwise*/
 typedef struct{
 	int table_size;
+	int capacity;
 	symtable_entry *symtable_entries;
+	symtable_slot *index;
+	int index_size;
 	int entry_flag;
+	int count_flag;
+	long lookups;
+	long compares;
+	arena *arena;
 } symtable;
 
-symtable *symtable_init();
-void symtable_free(symtable*);
+symtable *symtable_init(arena*);
 symtable_entry *find_symbol(const char*, symtable*);
+symtable_entry *find_symbol_n(const char*, const int, symtable*);
 symtable_entry *find_macro(const char*, symtable*);
+symtable_entry *find_macro_n(const char*, const int, symtable*);
 void update_data_sym_values(symtable*, const int);
 error_value add_symbol(symtable*, const char*, const int, symbol_type);
 
@@ -0,0 +1,9 @@
+;file test3.as
+
+.entry MSG
+MAIN:          lea MSG, r1
+               prn #2
+               lea PAD, r2
+END:           stop
+MSG:           .string "hello world"
+PAD:           .string "  a	b  "
@@ -0,0 +1,86 @@
+#include "trace.h"
+#include "file_handler.h"
+
+/*the id of the process in the trace, there is only one*/
+#define TRACE_PID 1
+
+/*the names of the spans of the phases of a file, the total is the file itself*/
+static const char *span_names[NUM_OF_STATS_PHASES] = {
+	"read", "pass1", "pass2_prep", "pass2", "object file", "externals file",
+	"entries file", NULL
+};
+
+/* write_span : write a complete event of the trace
+ * parameters : fp     - the trace file
+ * 				name   - the name of the span
+ * 				cat    - the category of the span
+ * 				begin  - the time the span started in seconds
+ * 				dur    - the length of the span in seconds
+ * 				tid    - the thread the span ran on
+ * 				origin - the time the trace starts from
+ * return     :*/
+static void write_span(FILE *fp, const char *name, const char *cat, const double begin,
+					   const double dur, const int tid, const double origin) {
+	fprintf(fp, ",\n{\"name\": ");
+	print_json_string(fp, name);
+	fprintf(fp, ", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+			"\"pid\": %d, \"tid\": %d}", cat, 1e6 * (begin - origin), 1e6 * dur,
+			TRACE_PID, tid);
+}
+
+/* write_trace : write the spans of the files that were assembled as a JSON trace
+ * 				 of complete events that a trace viewer shows on a timeline, every
+ * 				 file is a span on the thread that assembled it and its phases
+ * 				 are spans inside it
+ * parameters  : file_name   - the name of the trace file
+ * 				 jobs        - the jobs of the files, with statistics
+ * 				 num_of_jobs - the number of jobs
+ * 				 begin       - the time the assembler started
+ * 				 end         - the time the last file was done
+ * return      : NO_ERROR          - if the trace was written
+ * 				 ERROR_CREATE_FILE - if the trace file couldnt be written*/
+error_value write_trace(const char *file_name, file_job *jobs, const int num_of_jobs,
+						const double begin, const double end) {
+	FILE 		   *fp;
+	assembly_stats *stats;
+	int 		   i,
+				   phase,
+				   max_worker = 0,
+				   failed;
+
+	if (!(fp = fopen(file_name, WRITE)))
+		return ERROR_CREATE_FILE;
+
+	/*the whole run is a span on the main thread*/
+	fprintf(fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+	fprintf(fp, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, "
+			"\"args\": {\"name\": \"assembler\"}}", TRACE_PID);
+	write_span(fp, "assemble", "run", begin, end - begin, 0, begin);
+
+	for (i = 0; i < num_of_jobs; i++) {
+		stats = jobs[i].stats;
+		if (jobs[i].worker > max_worker)
+			max_worker = jobs[i].worker;
+
+		write_span(fp, jobs[i].file_base, "file", stats->phases[STATS_TOTAL].begin,
+				   stats->phases[STATS_TOTAL].wall, jobs[i].worker, begin);
+		for (phase = 0; phase < NUM_OF_STATS_PHASES; phase++)
+			if (span_names[phase] && stats->phases[phase].begin)
+				write_span(fp, span_names[phase], "phase", stats->phases[phase].begin,
+						   stats->phases[phase].wall, jobs[i].worker, begin);
+	}
+
+	/*name the threads so the workers are told apart from the main thread*/
+	for (i = 0; i <= max_worker; i++) {
+		fprintf(fp, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, "
+				"\"tid\": %d, \"args\": {\"name\": ", TRACE_PID, i);
+		if (i)
+			fprintf(fp, "\"worker %d\"}}", i);
+		else
+			fprintf(fp, "\"main\"}}");
+	}
+	fprintf(fp, "\n]}\n");
+	failed = ferror(fp);
+
+	return fclose(fp) || failed ? ERROR_CREATE_FILE : NO_ERROR;
+}
@@ -0,0 +1,10 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "defs.h"
+#include "error.h"
+#include "job.h"
+
+error_value write_trace(const char*, file_job*, const int, const double, const double);
+
+#endif
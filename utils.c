@@ -3,47 +3,29 @@
 
 /* line_valid : check if a line is a valid line
  * parameters : line - the line to check
+ * 				scan - a pointer to the pre-scan of the line
  * return     : LINE_TOO_LONG     - if the line is too long
- * 				NO_ERROR          - if the line is valid
- * 			    INVALI_PARAMETERS - if line is NULL*/
-error_value line_valid(const char *line){
-	if(line)
-		/*check if the line is too long*/
-		return strlen(line) == MAX_LINE_LEN + 1 && line[MAX_LINE_LEN] != '\n' ? LINE_TOO_LONG : NO_ERROR;
-	else
-		return INVALID_PARAMETERS;
+ * 				NO_ERROR          - if the line is valid*/
+error_value line_valid(const char *line, const line_scan *scan){
+	/*check if the line is too long*/
+	return scan->len == MAX_LINE_LEN + 1 && line[MAX_LINE_LEN] != '\n' ? LINE_TOO_LONG : NO_ERROR;
 }
 
 /* is_empty_line : check if the line is empty
- * parameters    : line - the line to check
+ * parameters    : scan - a pointer to the pre-scan of the line
  * return        : TRUE  - if the line is empty
  * 				   FALSE - if the line is not empty*/
-int is_empty_line(const char *line){
-	int len = strlen(line),
-		i,
-		empty = line ? TRUE : FALSE;
-
-	/*itterate over the line and look for a non space character*/
-	for(i = 0; i < len && empty; i++)
-		if(!isspace(line[i]))
-			empty = FALSE;
-
-	return empty;
+int is_empty_line(const line_scan *scan){
+	return scan->first == scan->len ? TRUE : FALSE;
 }
 
 /* is_comment_line : check if the line is a comment line
- * parameters      : line - the line to check
+ * parameters      : scan - a pointer to the pre-scan of the line
  * return          : TRUE  - if the line is a comment line
  * 					 FALSE - if the line is not a comment line*/
-int is_comment_line(const char *line){
-	const char *p = line;
-	int 	   len = strlen(line), i;
-
-	/*look for the first non space line*/
-	for(i = 0; i < len && isspace(*p); i++, p++);
-
-	/*if its a ';' then its a comment line*/
-	return *p == ';' ? TRUE : FALSE;
+int is_comment_line(const line_scan *scan){
+	/*if the first non blank character is a ';' then its a comment line*/
+	return scan->comment == scan->first ? TRUE : FALSE;
 }
 
 /* valid_label : chekc if a label is a valid label
@@ -54,11 +36,36 @@ int is_comment_line(const char *line){
  * 				 LABEL_TOO_LONG - if the label is too long
 				 RESERVED_WORD  - if the label is a reserved word */
 error_value valid_label(const char *label, symtable *symtable_p){
-	int         i,
-		        len = strlen(label);
+	return valid_label_n(label, strlen(label), symtable_p);
+}
+
+/* valid_label_n : check if a part of a longer string is a valid label
+ * parameters    : label      - the start of the label to check
+ * 				   len        - the length of the label
+ * 				   symtable_p - a pointer to a symbol table
+ * return        : NO_ERROR       - if the label is valid
+ * 				   INVALID_LABEL  - if the label is invalid
+ * 				   LABEL_TOO_LONG - if the label is too long
+ * 				   RESERVED_WORD  - if the label is a reserved word */
+error_value valid_label_n(const char *label, const int len, symtable *symtable_p){
+	error_value err_val = valid_label_syntax(label, len);
+
+	/*check if the label is a reserved word */
+	return !err_val && find_keyword_n(label, len) ? RESERVED_WORD : err_val;
+}
+
+/* valid_label_syntax : check if a label is made of the characters of a label
+ * 						without checking if it is a reserved word
+ * parameters         : label - the label to check
+ * 						len   - the length of the label
+ * return             : NO_ERROR       - if the label is valid
+ * 						INVALID_LABEL  - if the label is invalid
+ * 						LABEL_TOO_LONG - if the label is too long*/
+error_value valid_label_syntax(const char *label, const int len){
+	int         i;
 
 	/*check if the first characther is a letter*/
-	error_value err_val = len == 0 || isalpha(label[0]) ? NO_ERROR : INVALID_LABEL;
+	error_value err_val = len == 0 || char_is(label[0], CHAR_ALPHA) ? NO_ERROR : INVALID_LABEL;
 
 	/*check if the label is not too long*/
 	if(!err_val && len > MAX_LABEL_LEN)
@@ -66,33 +73,20 @@ error_value valid_label(const char *label, symtable *symtable_p){
 
 	/*chekc if the label is alphanumeric*/
 	for(i = 1; !err_val && i < len; i++){
-		if(!isalnum(label[i]))
+		if(!char_is(label[i], CHAR_ALNUM))
 			err_val = INVALID_LABEL;
 	}
 
-	/*check if the label is a reserved word */
-	err_val = !err_val && is_reserved_word(label) ? RESERVED_WORD : err_val;
-
 	return err_val;
 }
 
-/* valid_instruction : check if an instruction is a valid instruction
- * parameters        : str - the string to check
- * return            : NO_ERROR           - if the instruction is valid
- * 					   INVALID_INSTRCTION - if the string is invalid instruciton*/
-error_value valid_instruction(const char *str){
-	return get_op_value(str) >= 0 ? NO_ERROR : INVALID_INSTRUCTION;
-}
-
-/* is reserved_word : check if a string is a reserved word
+/* is reserved_word : check if a string is a reserved word, an operation, a register
+ * 					  or a directive
  * parameters       : str - the string to check
  * return           : non zero value if the string is a reserved word
  * 				      else return zero*/
 int is_reserved_word(const char *str){
-	return get_op_value(str) < 0 &&
-		   valid_directive(str) &&
-		   strcmp(str, ".define") &&
-		   get_reg_val(str) < 0 ? FALSE : TRUE;
+	return find_keyword(str) ? TRUE : FALSE;
 }
 
 /* valid_macro : check if a string is a valid macro name
@@ -104,16 +98,17 @@ int is_reserved_word(const char *str){
  * 				 DUPLICATE_MACRO - if the macro name has already been defined*/
 error_value valid_macro_name(const char *macro, symtable *symtable_p){
 	/*check if the first character is a letter*/
-	error_value err_val = isalpha(macro[0]) ? NO_ERROR : INVALID_MACRO;
-	int 		i;
+	error_value err_val = char_is(macro[0], CHAR_ALPHA) ? NO_ERROR : INVALID_MACRO;
+	int 		i,
+				len = strlen(macro);
 
 	/*check if the name is too long*/
-	if(!err_val && strlen(macro) > MAX_LABEL_LEN)
+	if(!err_val && len > MAX_LABEL_LEN)
 		err_val = MACRO_TOO_LONG;
 
 	/*check if the name is alphanumeric	*/
-	for(i = 0; !err_val && i < strlen(macro); i++)
-		if(!isalnum(macro[i]))
+	for(i = 0; !err_val && i < len; i++)
+		if(!char_is(macro[i], CHAR_ALNUM))
 			err_val = INVALID_MACRO;
 
 	/*check if the macro already defined and return the result*/
@@ -125,13 +120,22 @@ error_value valid_macro_name(const char *macro, symtable *symtable_p){
  * return          : non zero value if the string is a valid number
  * 					 else return zero*/
 int is_legal_number(const char *str){
+	return is_legal_number_n(str, strlen(str));
+}
+
+/* is_legal_number_n : check if a part of a longer string is a legal number
+ * parameters        : str - the start of the string to check
+ * 					   len - the length of the string
+ * return            : non zero value if the string is a valid number
+ * 					   else return zero*/
+int is_legal_number_n(const char *str, const int len){
 	/*check if the first character is a '-' , '+' or a digit*/
-	int legal = str[0] == '-' || str[0] == '+' || isdigit(str[0]) ? TRUE : FALSE,
+	int legal = len && char_is(str[0], CHAR_SIGN | CHAR_DIGIT) ? TRUE : FALSE,
 	    i;
 
 	/*check if all the character*/
-	for(i = 1; legal && i < strlen(str); i++)
-		if(!isdigit(str[i]))
+	for(i = 1; legal && i < len; i++)
+		if(!char_is(str[i], CHAR_DIGIT))
 			legal = FALSE;
 
 	return legal;
@@ -149,64 +153,46 @@ int is_valid_string(const char *str){
 
 	/*check if every character is a alphanumeric or space*/
 	for(i = 1; valid && i < len - 1; i++)
-		if(!isalnum(str[i]) && !isspace(str[i]))
+		if(!char_is(str[i], CHAR_ALNUM | CHAR_BLANK))
 			valid = FALSE;
 
 	return valid;
 }
 
-/* is_valid_data_params : check if the string is a valid data parameters string
- * parameters           : str        - the string to check
- * 						  symtable_p - a pointer to a symbol table
- * return               : non zero value if the string a valid data parameters
- * 						  else return zeor*/
-int is_valid_data_params(const char *str, symtable *symtable_p){
-	int  len = strlen(str);
-	int  valid = TRUE;
-	char *temp,
-		 param_cpy[MAX_LINE_LEN];
+/* is_valid_data_params : check if the comma separated parameters of a data directive
+ * 						  are valid
+ * parameters           : line          - the line the parameters are in
+ * 						  params        - the parameters, every comma starts a new one
+ * 						  num_of_params - the number of parameters
+ * 						  symtable_p    - a pointer to a symbol table
+ * return               : non zero value if the parameters are valid
+ * 						  else return zero*/
+int is_valid_data_params(const char *line, const token *params, const int num_of_params,
+						 symtable *symtable_p){
+	int len,
+		i,
+		valid = TRUE;
 
-	/*create a copy of the string to no alter the original */
-	strcpy(param_cpy, str);
+	/*the length of the parameters with the commas between them*/
+	for(i = 0, len = num_of_params - 1; i < num_of_params; i++)
+		len += params[i].len;
 
 	/*check if theres a comma at the end or begginigs*/
 	if(len >= 2){
-		valid = str[0] == ',' || str[len - 1] == ',' ? FALSE : TRUE;
-
-		/*check if there adjecent commasd in the string */
-		if(valid)
-			valid = !is_adjacent_commas(str);
-
+		valid = !params[0].len || !params[num_of_params - 1].len ? FALSE : TRUE;
 
 		/*check if every parameter is a number of a defined macro*/
-		for(temp = strtok(param_cpy, ","); valid && temp; temp = strtok(NULL, ","))
-			if(!is_legal_number(temp) && !find_symbol(temp, symtable_p))
+		for(i = 0; valid && i < num_of_params; i++)
+			if(params[i].len && !is_legal_number(line + params[i].offset) &&
+			   !find_symbol(line + params[i].offset, symtable_p))
 				valid = FALSE;
 
-	} else if(len == 1 && !isdigit(str[0]))
+	} else if(len == 1 && !char_is(line[params[0].offset], CHAR_DIGIT))
 		valid = FALSE;
 
 	return valid;
 }
 
-/* is_adjacent_commas : chekc if there are adjacent commas on a string
- * parameters         : str - the string to check
- * return             : non zero value if there are adjacent commas
- *                      else return zero*/
-int is_adjacent_commas(const char *str){
-	int i,
-		len = strlen(str),
-		adj_comma = FALSE;
-
-	/*check if there are two adjacent commas*/
-	for(i = 0; adj_comma && i < len - 1; i++){
-		if(str[i] == ',' && str [i + 1] == ',')
-			adj_comma = TRUE;
-	}
-
-	return adj_comma;
-}
-
 /* is_valid_instruction_param : check if the parameter is a valid parameter for an instruction
  * parameters                 : param      - the parameter to check
  * 							    symtable_p - a pointer to a symbol table
@@ -216,11 +202,11 @@ int is_valid_instruction_param(const char *param, symtable *symtable_p){
 	int valid;
 
 	/*check if it and empty parameter*/
-	if(is_empty_line(param))
+	if(!param[0])
 		valid = TRUE;
-	/*check if its a number parameter or macro*/
+	/*check if its a number parameter or macro, a '#' alone is the number 0*/
 	else if(param[0] == '#'){
-		if(!(valid = is_legal_number(param + 1)))
+		if(!(valid = !param[1] || is_legal_number(param + 1)))
 			valid = find_macro(param + 1, symtable_p) ? TRUE : FALSE;
 		/*check if the parameter is a register*/
 	}else if(param[0] == 'r' && get_reg_val(param) >= 0)
@@ -241,63 +227,17 @@ int is_valid_instruction_param(const char *param, symtable *symtable_p){
  * return         : non zero value if the parameter is a valid array parameter
  * 					else return zero*/
 int is_array_param(const char *param, symtable *symtable_p){
-	char *index,
-		 *end, name[MAX_LABEL_LEN];
-	int  is_array = FALSE;
-
-	/*make a copy of the parameters to not alter the original*/
-	strcpy(name, param);
-
-	/*check if there are '[' and ']'*/
-	if((index = strchr(name, '[')) && (end = strchr(name, ']'))){
-		/*check of the '[' comes before the ']'*/
-		if(index < end){
-
-			*(index++) = '\0';
-			*end = '\0';
-			/*check if the name of the array ia a valid label*/
-			if((is_array = !valid_label(name, symtable_p)))
-				/*check if the index is a number or a valid macro*/
-				is_array = is_legal_number(index) || find_macro(index, symtable_p);
-		}
-	}
+	const char *index,
+			   *end;
+	int  	   is_array = FALSE;
+
+	/*check if there are '[' and ']' and if the '[' comes before the ']'*/
+	if((index = strchr(param, '[')) && (end = strchr(param, ']')) && index++ < end)
+		/*check if the name of the array ia a valid label*/
+		if((is_array = !valid_label_n(param, index - param - 1, symtable_p)))
+			/*check if the index is a number or a valid macro*/
+			is_array = is_legal_number_n(index, end - index) ||
+					   find_macro_n(index, end - index, symtable_p);
 
 	return is_array;
 }
-
-/* get_arr_name : get the name of an array parameter
- * parameters   : str_in  - the string of the array
- * 				  str_out - the output string for the name
- * return       :
- */
-void get_arr_name(const char *str_in, char *str_out){
-	strcpy(str_out, str_in);
-	strchr(str_out, '[')[0] = '\0';
-}
-
-/* get_arr_index : get the index of an array parameter
- * parameters    : str_in  - the string with the array
- * 				   str_out - the output string for the index
- * return        :
- */
-void get_arr_index(const char *str_in, char *str_out){
-	char *start;
-
-	start = strchr(str_in, '[');
-	strcpy(str_out, ++start);
-	strchr(str_out, ']')[0] = '\0';
-}
-
-/* find_eq_sign : ind an '=' sign in a string
- * parameters   : str - the string to look at
- * return       : if found then return a pointer to the '=' sign
- * 				  else return NULL*/
-char *find_eq_sign(char *str){
-	char *p = str;
-
-	for(; *p; p++)
-		if(*p == '=')
-			break;
-
-	return (*p == '=') ? p : NULL;
-}